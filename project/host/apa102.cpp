@@ -0,0 +1,129 @@
+// APA102 encoding, Message padding, Unchanged and Frames prefixes
+
+#include <random>
+#include <vector>
+
+#include "APA102.h"
+
+#include "check.h"
+
+using APA102::LED;
+
+static void testEncode() {
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> part {-64, 0x1040};
+    GammaEncode12 const gammaEncode {2.0f};
+    size_t constexpr size {257};
+    std::vector<LED<int16_t>> leds;
+    std::vector<uint16_t> layout;
+    for (size_t i {0}; i < size; ++i) {
+	leds.emplace_back(part(rng), part(rng), part(rng));
+	layout.push_back((i * 7) % size);	// a permutation
+    }
+    leds[0] = {0, 0, 0};
+    leds[1] = {1, 0, 0};
+    leds[2] = {0xfff, 0xfff, 0xfff};
+    std::vector<uint32_t> fused(size), inOrder(size);
+    APA102::encode(fused.data(), leds.data(), size, gammaEncode, layout.data());
+    APA102::encode(inOrder.data(), leds.data(), size, gammaEncode);
+    for (size_t i {0}; i < size; ++i) {
+	LED<int16_t> const & l {leds[i]};
+	uint32_t const expected {LED<int16_t> {
+	    gammaEncode(l.part.red),
+	    gammaEncode(l.part.green),
+	    gammaEncode(l.part.blue)}};
+	check(expected == fused[layout[i]]);
+	check(expected == inOrder[i]);
+	// three start bits and something out for anything in
+	LED<> const out {expected};
+	check(0b11100000 == (out.part.control & 0b11100000));
+	check(!(0 < l.part.red)		== !out.part.red);
+	check(!(0 < l.part.green)	== !out.part.green);
+	check(!(0 < l.part.blue)	== !out.part.blue);
+    }
+}
+
+static void testMessage() {
+    // the smallest messages still cover their bits
+    APA102::Message<1> const message1;
+    check(sizeof message1 * 8 >= message1.length());
+    APA102::Message<2> const message2;
+    check(sizeof message2 * 8 >= message2.length());
+    check(LED<>() == message1.encodings[0]);
+}
+
+static void testUnchanged() {
+    unsigned constexpr refresh {4};
+    APA102::Unchanged unchanged {refresh};
+    uint32_t encodings[3] {1, 2, 3};
+    check(!unchanged(encodings, 3));	// never skip the first
+    for (unsigned i {1}; i < refresh; ++i) {
+	check(unchanged(encodings, 3));
+    }
+    check(!unchanged(encodings, 3));	// refreshed
+    check(unchanged(encodings, 3));
+    encodings[1] = 4;
+    check(!unchanged(encodings, 3));
+    check(refresh == unchanged.skipped());
+}
+
+// simulate a chain of LEDs that are sent the changed prefix of each frame.
+static void testFrames() {
+    size_t constexpr size {97};
+    APA102::Frames<size> frames;
+    std::mt19937 rng;
+    std::uniform_int_distribution<size_t> index {0, size - 1};
+    std::uniform_int_distribution<uint32_t> color {0, 0xffffff};
+    std::vector<uint32_t> displayed(size, LED<>());
+    std::vector<uint32_t> expected(size, LED<>());
+
+    check(0 == frames.flipPrefix());	// nothing changed
+
+    for (unsigned frame {0}; frame < 10000; ++frame) {
+	frames.copyFront();
+	uint32_t * const back {frames.back().encodings};
+	for (size_t i {0}; i < size; ++i) {
+	    check(back[i] == expected[i]);
+	}
+	// change a few LEDs (or none) at random
+	for (auto n = frame % 4; n--;) {
+	    size_t const i {index(rng)};
+	    expected[i] = back[i] = 0xff | color(rng) << 8;
+	}
+	bool const full {!(frame % 16)};
+	std::size_t const length {frames.flipPrefix(full)};
+	if (!length) {
+	    check(!full);
+	    continue;
+	}
+	// the prefix covers (exactly) what changed
+	size_t end {size};
+	while (!full && end && displayed[end - 1] == expected[end - 1]) --end;
+	check(APA102::messageBits(end) == length);
+
+	// what is clocked out: a zero start word, the prefix encodings and
+	// enough zeros (all that follow them) to clock them through
+	auto const & front {frames.front()};
+	uint32_t const * const words {reinterpret_cast<uint32_t const *>(&front)};
+	check(0 == words[0]);
+	check(sizeof front * 8 >= length);
+	for (size_t i {0}; i < end; ++i) {
+	    displayed[i] = words[1 + i];
+	}
+	uint8_t const * const bytes {reinterpret_cast<uint8_t const *>(&front)};
+	for (size_t b {4 * (1 + end)}; b < (length + 7) / 8; ++b) {
+	    check(0 == bytes[b]);
+	}
+	for (size_t i {0}; i < size; ++i) {
+	    check(displayed[i] == expected[i]);
+	}
+    }
+}
+
+int main() {
+    testEncode();
+    testMessage();
+    testUnchanged();
+    testFrames();
+    return checkFailures();
+}
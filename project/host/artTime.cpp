@@ -0,0 +1,166 @@
+// artTime runs the real art task (the DerivedArtTask of ArtLightApplication_h,
+// as in ../main/main.cpp) on the host stand-ins for esp-idf (idf/*)
+// with the preferences given (published before it is created, as if stored)
+// and, after a few frames, measures frames as they are rendered
+// and transmitted (to the SPI, I2C and LEDC stand-ins, in their time):
+// frames per second, render and encode times (from its FrameStats)
+// and heap allocations per frame (of all tasks but this one).
+// a "frames" partition with a capture to play back is provided.
+// time is real (frames are due as the FrameScheduler schedules them)
+// so fps is that of the schedule unless frames take too long.
+// the host is much faster than the target but the allocations are telling.
+//
+//	./artTimeGolden [frames [key=value ...]]
+//	./artTimeGolden 100 mode=swirl
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Idf.h"
+
+#include "Capture.h"
+#include "KeyValueBroker.h"
+
+#include ArtLightApplication_h
+
+static std::atomic<unsigned long> allocations {0};
+static thread_local bool uncounted {false};
+
+void * operator new(std::size_t size) {
+    if (!uncounted) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void * const pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * pointer) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class StringSink : public Capture::Sink {
+public:
+    std::string stream;
+
+    void header(uint8_t const * data, std::size_t size) override {
+	stream.append(reinterpret_cast<char const *>(data), size);
+    }
+    void frame(uint8_t const * data, std::size_t size, bool) override {
+	stream.append(reinterpret_cast<char const *>(data), size);
+    }
+};
+
+// a capture of ledCount LEDs (in rendering order) that chase for a second
+std::string const & frames() {
+    static std::string const stream {[](){
+	std::size_t constexpr ledCount {1024};
+	StringSink sink;
+	Capture::Recorder recorder {sink, Capture::Chip::apa102, ledCount};
+	std::vector<uint32_t> encodings(ledCount, 0xe0000000);
+	for (std::size_t f {0}; f < 25; ++f) {
+	    for (std::size_t i {f}; i < ledCount; i += 25) {
+		encodings[i] = 0xe1000000 | (i << 8 & 0xffff00);
+	    }
+	    recorder.record(1000000 + f * 40000, encodings.data());
+	}
+	return sink.stream;
+    }()};
+    return stream;
+}
+
+// the number that follows field (after stage) in the _stats value of json
+// (or 0, if there is none)
+unsigned long statOf(std::string const & json, char const * stage,
+    char const * field)
+{
+    std::size_t at {json.find("\"_stats\"")};
+    if (std::string::npos == at) return 0;
+    if (std::string::npos == (at = json.find(stage, at))) return 0;
+    if (std::string::npos == (at = json.find(field, at))) return 0;
+    at = json.find_first_of("0123456789", at + std::strlen(field));
+    if (std::string::npos == at) return 0;
+    return std::strtoul(json.c_str() + at, nullptr, 10);
+}
+
+// frames started (as counted by FrameStats) once frames have started
+// or the deadline has passed
+unsigned long waitFor(KeyValueBroker & keyValueBroker, unsigned long frames,
+    Clock::time_point deadline)
+{
+    for (;;) {
+	unsigned long const started
+	    {statOf(keyValueBroker.serialize(), "latency", "count")};
+	if (frames <= started || deadline <= Clock::now()) return started;
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+}
+
+int main(int argc, char ** argv) {
+    uncounted = true;
+    unsigned long const count {argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+	: 100ul};
+    unsigned long constexpr warmCount {5};
+
+    Idf::addPartition("frames", frames().data(), frames().size());
+
+    KeyValueBroker keyValueBroker {"keyValueBroker"};
+
+    // the preferences are observed from the start
+    std::string preferences;
+    for (int i {2}; i < argc; ++i) {
+	std::string const preference {argv[i]};
+	std::size_t const equals {preference.find('=')};
+	if (std::string::npos == equals) {
+	    std::fprintf(stderr, "%s: not key=value\n", argv[i]);
+	    return EXIT_FAILURE;
+	}
+	keyValueBroker.publish(preference.substr(0, equals).c_str(),
+	    preference.substr(equals + 1).c_str());
+	preferences += ' ' + preference;
+    }
+
+    DerivedArtTask * const artTask {new DerivedArtTask {keyValueBroker}};
+    artTask->start();
+
+    Clock::time_point const deadline
+	{Clock::now() + std::chrono::seconds(30 + count / 10)};
+    unsigned long const warm
+	{waitFor(keyValueBroker, warmCount, deadline)};
+    unsigned long const allocated0 {allocations};
+    Clock::time_point const start {Clock::now()};
+    unsigned long const frames {waitFor(keyValueBroker, warm + count, deadline)
+	- warm};
+    unsigned long const allocated {allocations - allocated0};
+    double const seconds
+	{std::chrono::duration<double>(Clock::now() - start).count()};
+
+    // stages are timed in nanoseconds (not cycles) on the host
+    std::string const json {keyValueBroker.serialize()};
+    std::printf("%s%s: frames %lu fps %.1f"
+	" render p50 %lu p99 %lu encode p50 %lu ns"
+	" allocations per frame %.2f\n",
+	ArtLightApplication_h, preferences.c_str(), frames,
+	frames / seconds,
+	statOf(json, "render", "p50"), statOf(json, "render", "p99"),
+	statOf(json, "encode", "p50"),
+	frames ? static_cast<double>(allocated) / frames : 0.0);
+
+    // the art task is not destroyed (it never is on the target):
+    // its tasks run until we exit
+    (void) artTask;
+    std::fflush(stdout);
+    // (frames are counted every so often so there may be a few more)
+    std::_Exit(count <= frames ? EXIT_SUCCESS : EXIT_FAILURE);
+}
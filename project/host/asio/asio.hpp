@@ -0,0 +1,18 @@
+#pragma once
+
+// host stand-in for the standalone asio of esp-idf:
+// Boost.Asio (which is also header-only), as asio.
+// asio::error_code is as it is in standalone asio.
+// sdkconfig.h is included as it is (through lwip) in esp-idf.
+
+#include <boost/asio.hpp>
+
+#include "sdkconfig.h"
+
+namespace boost {
+namespace asio {
+using error_code = boost::system::error_code;
+}
+}
+
+namespace asio = boost::asio;
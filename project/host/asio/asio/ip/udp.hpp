@@ -0,0 +1,6 @@
+#pragma once
+
+// host stand-in (see ../../asio.hpp)
+
+#include "asio.hpp"
+#include <boost/asio/ip/udp.hpp>
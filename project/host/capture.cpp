@@ -0,0 +1,149 @@
+// Capture: what a Recorder writes (to a FileSink or a RingSink)
+// a Reader reads and a Player plays in time
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Capture.h"
+
+#include "check.h"
+
+using namespace Capture;
+
+namespace {
+
+size_t constexpr ledCount {61};
+
+using Frame = std::vector<uint32_t>;
+
+// frames that change a few LEDs (or none) from one to the next
+std::vector<Frame> makeFrames(size_t count) {
+    std::mt19937 rng;
+    std::uniform_int_distribution<size_t> index {0, ledCount - 1};
+    std::vector<Frame> frames;
+    Frame frame(ledCount, 0xe0000000);
+    for (size_t f {0}; f < count; ++f) {
+	for (auto n = f % 5; n--;) frame[index(rng)] = rng() | 0xe0000000;
+	frames.push_back(frame);
+    }
+    return frames;
+}
+
+uint64_t timeOf(size_t f) {return 1000000 + f * 40000 + f % 3;}
+
+// all frames (but those unchanged) are read back in order
+void testFile() {
+    std::vector<uint16_t> layout;
+    for (size_t i {0}; i < ledCount; ++i) layout.push_back(ledCount - 1 - i);
+    auto const frames {makeFrames(1000)};
+
+    std::FILE * const file {std::tmpfile()};
+    check(file);
+    if (!file) return;
+    {
+	FileSink sink {file};
+	Recorder recorder {sink, Chip::sk9822, ledCount, layout.data(), 4096};
+	for (size_t f {0}; f < frames.size(); ++f) {
+	    recorder.record(timeOf(f), frames[f].data());
+	}
+    }
+    std::string stream(static_cast<size_t>(std::ftell(file)), '\0');
+    std::rewind(file);
+    check(stream.size() == std::fread(&stream[0], 1, stream.size(), file));
+    std::fclose(file);
+
+    Reader reader {reinterpret_cast<uint8_t const *>(stream.data()),
+	stream.size()};
+    check(reader);
+    check(Chip::sk9822 == reader.chip());
+    check(ledCount == reader.ledCount());
+    check(layout == reader.layout());
+    for (unsigned pass {0}; pass < 2; ++pass) {
+	size_t f {0};
+	while (reader.next()) {
+	    while (f < frames.size() && frames[f] != reader.encodings()) ++f;
+	    check(f < frames.size());
+	    if (f == frames.size()) break;
+	    check(timeOf(f) == reader.microseconds());
+	    // those that we skipped were unchanged
+	    ++f;
+	}
+	check(frames.size() == f);
+	reader.rewind();
+    }
+
+    // a truncated stream reads (what it has) without error
+    Reader truncated {reinterpret_cast<uint8_t const *>(stream.data()),
+	stream.size() - 3};
+    check(truncated);
+    size_t count {0};
+    while (truncated.next()) ++count;
+    check(count);
+}
+
+// a RingSink keeps the most recent frames from a key frame on
+void testRing() {
+    auto const frames {makeFrames(2000)};
+    RingSink sink {4096};
+    Recorder recorder {sink, Chip::apa102, ledCount, nullptr, 1024};
+    for (size_t f {0}; f < frames.size(); ++f) {
+	recorder.record(timeOf(f), frames[f].data());
+    }
+    check(0 == sink.drops());
+    std::string const stream {sink.copy()};
+    check(stream.size() <= 4096 + 8 + 2 * ledCount + 4096);
+
+    Reader reader {reinterpret_cast<uint8_t const *>(stream.data()),
+	stream.size()};
+    check(reader);
+    check(ledCount == reader.layout().size());
+    for (size_t i {0}; i < ledCount; ++i) check(i == reader.layout()[i]);
+    uint64_t microseconds {0};
+    size_t count {0};
+    bool last {false};
+    while (reader.next()) {
+	check(microseconds < reader.microseconds());
+	microseconds = reader.microseconds();
+	size_t const f {(microseconds - 1000000) / 40000};
+	check(f < frames.size() && frames[f] == reader.encodings());
+	last = frames.size() - 1 == f;
+	++count;
+    }
+    check(count);
+    check(last);
+}
+
+// a Player plays each frame when it is due, looping at the end
+void testPlayer() {
+    auto const frames {makeFrames(8)};
+    RingSink sink {1 << 16};
+    Recorder recorder {sink, Chip::apa102, ledCount};
+    for (size_t f {0}; f < frames.size(); ++f) {
+	recorder.record(f * 1000, frames[f].data());
+    }
+    std::string const stream {sink.copy()};
+    Player player {reinterpret_cast<uint8_t const *>(stream.data()),
+	stream.size()};
+    check(player);
+    player.start(500000);
+    for (unsigned loop {0}; loop < 2; ++loop) {
+	int64_t const origin {500000 + loop * 8 * 1000};
+	for (size_t f {0}; f < frames.size(); ++f) {
+	    int64_t const due {origin + static_cast<int64_t>(f) * 1000};
+	    if (f) check(frames[f - 1] == player(due - 1));
+	    check(frames[f] == player(due));
+	    check(frames[f] == player(due + 1));
+	}
+    }
+}
+
+}
+
+int main() {
+    testFile();
+    testRing();
+    testPlayer();
+    return checkFailures();
+}
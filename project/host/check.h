@@ -0,0 +1,20 @@
+#pragma once
+
+// a minimal check for host tests:
+// a failed check is reported (but the test goes on)
+// and main returns checkFailures() as its exit status.
+
+#include <cstdio>
+
+inline unsigned & checkFailures() {
+    static unsigned failures {0};
+    return failures;
+}
+
+#define check(condition) do { \
+    if (!(condition)) { \
+	std::fprintf(stderr, "%s:%d: check failed: %s\n", \
+	    __FILE__, __LINE__, #condition); \
+	++checkFailures(); \
+    } \
+} while (0)
@@ -0,0 +1,144 @@
+// dialTime measures, on the host, the time that rendering one golden dial
+// (all places on its rim) takes, for each shape and some rim sizes,
+// before (through a std::function made for each dial, as GoldenArtTask did)
+// and after (with a statically dispatched shape kernel, as it does now).
+// both must render the same.
+//
+//	./dialTime [dials]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "APA102.h"
+#include "Blend.h"
+#include "Curve.h"
+#include "DialShape.h"
+
+#include "check.h"
+
+using APA102::LED;
+using Clock = std::chrono::steady_clock;
+using Render = std::function<LED<int16_t>(float)>;
+
+enum Shape {bellShape, waveShape, bloomShape, shapeCount};
+static char const * const shapeName[shapeCount] {"bell", "wave", "bloom"};
+
+// the parameters of a dial at a time
+struct DialAt {
+    unsigned	rimSize;
+    float	position;
+    float	width;
+    float	phase;
+    unsigned	closest() const {
+	return static_cast<unsigned>(position * rimSize + 0.5f) % rimSize;
+    }
+};
+
+static LED<int16_t> const faded {0x800, 0x400, 0x200};
+
+// before: a std::function, as GoldenArtTask made it
+static Render renderOf(Shape shape, DialAt const & d) {
+    Blend<LED<int16_t>> const blend {LED<int16_t> {}, faded};
+    HalfDial const dial {d.position, false};
+    BellCurve<> const bell {0.0f, d.width};
+    switch (shape) {
+    case bellShape:
+	return [dial, bell, blend](float place) {
+	    float const offset {dial(place)};
+	    return blend(bell(offset));
+	};
+    case waveShape: {
+	WaveDial const wave {d.phase * 2.0f / d.rimSize, 2.0f / d.rimSize};
+	return [dial, bell, wave, blend](float place) {
+	    auto const offset {dial(place)};
+	    return blend(bell(offset) * wave(place));
+	};
+    }
+    default: {
+	BumpCurve const bump {0.0f, d.width};
+	BloomCurve const bloom {0.0f, d.width, d.phase};
+	return [dial, bump, bloom, blend](float place) {
+	    float const offset {dial(place)};
+	    return blend(bump(offset) * bloom(offset));
+	};
+    }
+    }
+}
+
+static void renderBefore(Shape shape, DialAt const & d,
+    LED<int16_t> * values)
+{
+    Render const render {renderOf(shape, d)};
+    unsigned const closest {d.closest()};
+    for (auto j {0u}; j < d.rimSize; ++j) {
+	values[j] = j == closest ? faded
+	    : render(static_cast<float>(j) / d.rimSize);
+    }
+}
+
+// after: a shape kernel, as GoldenArtTask's DialRender selects it
+static void renderAfter(Shape shape, DialAt const & d,
+    LED<int16_t> * values)
+{
+    Blend<LED<int16_t>> const blend {LED<int16_t> {}, faded};
+    HalfDial const dial {d.position, false};
+    BellCurve<> const bell {0.0f, d.width};
+    switch (shape) {
+    case bellShape:
+	renderRim(BellShape {dial, bell},
+	    blend, faded, d.rimSize, d.closest(), values);
+	break;
+    case waveShape: {
+	WaveDial const wave {d.phase * 2.0f / d.rimSize, 2.0f / d.rimSize};
+	renderRim(WaveShape {dial, bell, wave},
+	    blend, faded, d.rimSize, d.closest(), values);
+    } break;
+    default: {
+	BumpCurve const bump {0.0f, d.width};
+	BloomCurve const bloom {0.0f, d.width, d.phase};
+	renderRim(BloomShape {dial, bump, bloom},
+	    blend, faded, d.rimSize, d.closest(), values);
+    } break;
+    }
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 10000u};
+
+    static LED<int16_t> before[144], after[144];
+    for (unsigned rimSize: {34u, 89u, 144u}) {
+	for (unsigned s {0}; s < shapeCount; ++s) {
+	    Shape const shape {static_cast<Shape>(s)};
+	    Clock::duration beforeTime {0}, afterTime {0};
+	    for (unsigned i {0}; i < count; ++i) {
+		// a second hand moving around the dial
+		DialAt const dial {rimSize, static_cast<float>(i % 600) / 600,
+		    2.0f * 16 / 64, static_cast<float>(i % 50) / 50};
+		auto const start {Clock::now()};
+		renderBefore(shape, dial, before);
+		auto const middle {Clock::now()};
+		renderAfter(shape, dial, after);
+		auto const end {Clock::now()};
+		beforeTime += middle - start;
+		afterTime += end - middle;
+		for (auto j {0u}; j < rimSize; ++j) {
+		    check(static_cast<uint32_t>(before[j])
+			== static_cast<uint32_t>(after[j]));
+		}
+	    }
+	    auto const perDial = [count](Clock::duration duration) {
+		return count ? std::chrono::duration<double, std::nano>(duration)
+		    .count() / count : 0.0;
+	    };
+	    std::printf("rim %3u %-5s nanoseconds per dial:"
+		" std::function %7.0f kernel %7.0f\n",
+		rimSize, shapeName[shape],
+		perDial(beforeTime), perDial(afterTime));
+	}
+    }
+    return checkFailures();
+}
@@ -0,0 +1,106 @@
+// forkJoin measures, on the host, the speedup of ForkJoin
+// (its helper task is a std::thread on the FreeRTOS stand-in)
+// over doing both sides of the same work, one after the other, in the caller.
+// the work is what GoldenArtTask forks: rendering dials on rims,
+// alternating dials between the sides.
+// both must render the same. where there is more than one hardware thread,
+// forking must be faster.
+//
+//	./forkJoin [frames]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "APA102.h"
+#include "Blend.h"
+#include "Curve.h"
+#include "DialShape.h"
+#include "ForkJoin.h"
+
+#include "check.h"
+
+using APA102::LED;
+using Clock = std::chrono::steady_clock;
+
+static unsigned constexpr dialCount {24};
+static unsigned constexpr rimSize {144};
+
+static LED<int16_t> const faded {0x800, 0x400, 0x200};
+
+// render the dials (of a frame) on side of them
+static void render(unsigned frame, unsigned side,
+    LED<int16_t> (* values)[rimSize])
+{
+    for (auto d {side}; d < dialCount; d += 2) {
+	Blend<LED<int16_t>> const blend {LED<int16_t> {}, faded};
+	float const position
+	    {static_cast<float>((frame + 25 * d) % 600) / 600};
+	float const width {2.0f * (8 + d) / 64};
+	unsigned const closest
+	    {static_cast<unsigned>(position * rimSize + 0.5f) % rimSize};
+	HalfDial const dial {position, 0 != (1 & d)};
+	BumpCurve const bump {0.0f, width};
+	BloomCurve const bloom
+	    {0.0f, width, static_cast<float>(frame % 50) / 50};
+	renderRim(BloomShape {dial, bump, bloom},
+	    blend, faded, rimSize, closest, values[d]);
+    }
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 2000u};
+
+    ForkJoin forkJoin {"forkJoin", 5, 8192, 0};
+    forkJoin.start();
+
+    static LED<int16_t> serial[dialCount][rimSize], forked[dialCount][rimSize];
+    Clock::duration serialTime {0}, forkedTime {0};
+    for (unsigned frame {0}; frame < count; ++frame) {
+	auto const start {Clock::now()};
+	render(frame, 0, serial);
+	render(frame, 1, serial);
+	auto const middle {Clock::now()};
+	forkJoin([frame](unsigned side) {
+	    render(frame, side, forked);
+	});
+	auto const end {Clock::now()};
+	serialTime += middle - start;
+	forkedTime += end - middle;
+	for (auto d {0u}; d < dialCount; ++d) {
+	    for (auto j {0u}; j < rimSize; ++j) {
+		check(static_cast<uint32_t>(serial[d][j])
+		    == static_cast<uint32_t>(forked[d][j]));
+	    }
+	}
+    }
+
+    // the cost of a fork and join itself
+    unsigned sides {0};
+    auto const start {Clock::now()};
+    for (unsigned frame {0}; frame < count; ++frame) {
+	forkJoin([&sides](unsigned side) {
+	    if (side) ++sides;
+	});
+    }
+    Clock::duration const emptyTime {Clock::now() - start};
+    check(count == sides);
+
+    auto const perFrame = [count](Clock::duration duration) {
+	return count ? std::chrono::duration<double, std::micro>(duration)
+	    .count() / count : 0.0;
+    };
+    unsigned const threads {std::thread::hardware_concurrency()};
+    std::printf("frames %u microseconds per frame: serial %.1f forked %.1f"
+	" (speedup %.2f on %u hardware threads) empty fork %.1f\n",
+	count, perFrame(serialTime), perFrame(forkedTime),
+	forkedTime.count()
+	    ? static_cast<double>(serialTime.count()) / forkedTime.count()
+	    : 0.0,
+	threads, perFrame(emptyTime));
+    if (1 < threads) check(forkedTime < serialTime);
+    return checkFailures();
+}
@@ -0,0 +1,161 @@
+// FrameScheduler cadence on a simulated clock under varying render cost.
+// this test is the esp_timer (one-shot timers on a clock that only
+// moves when the simulation advances it) so cadence is exact.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "esp_timer.h"
+
+#include "FrameScheduler.h"
+
+#include "check.h"
+
+// the simulated esp_timer
+
+struct esp_timer {
+    esp_timer_cb_t	callback;
+    void *		arg;
+    bool		armed;
+    int64_t		due;
+};
+
+static int64_t now {1000000};
+static esp_timer timer_;	// the only one
+
+esp_err_t esp_timer_create(esp_timer_create_args_t const * args,
+    esp_timer_handle_t * handle)
+{
+    timer_ = {args->callback, args->arg, false, 0};
+    *handle = &timer_;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout) {
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = true;
+    timer->due = now + timeout;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t) {
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+    return now;
+}
+
+namespace {
+
+uint32_t constexpr period {40000};	// 25 frames per second
+
+/// run count frames, each of which takes cost(frame) microseconds
+/// of work, and return when each started
+template <typename Cost>
+std::vector<int64_t> run(FrameScheduler & frameScheduler, unsigned count,
+    Cost const & cost, bool & pending)
+{
+    std::vector<int64_t> starts;
+    frameScheduler.start();
+    while (starts.size() < count) {
+	if (pending) {
+	    // the work of the frame that expired
+	    pending = false;
+	    starts.push_back(now);
+	    now += cost(starts.size() - 1);
+	    frameScheduler.done();
+	} else {
+	    // nothing to do until the timer expires
+	    check(timer_.armed);
+	    if (!timer_.armed) break;
+	    check(now < timer_.due);
+	    now = timer_.due;
+	    timer_.armed = false;
+	    timer_.callback(timer_.arg);
+	}
+    }
+    frameScheduler.stop();
+    return starts;
+}
+
+// frames that take less than a period start on its deadline schedule,
+// whatever they cost
+void testOnSchedule() {
+    std::mt19937 rng;
+    std::uniform_int_distribution<uint32_t> cost {0, period - 1};
+    bool pending {false};
+    FrameScheduler frameScheduler {"onSchedule", 25.0f,
+	[&pending](){pending = true;}};
+    int64_t const start {now};
+    auto const starts {run(frameScheduler, 1000, [&](size_t){
+	return cost(rng);
+    }, pending)};
+    for (size_t f {0}; f < starts.size(); ++f) {
+	check(start + static_cast<int64_t>(f + 1) * period == starts[f]);
+    }
+    check(0 == frameScheduler.overruns());
+    check(0 == frameScheduler.skips());
+}
+
+// a frame that overruns by more than a period starts the next at once,
+// skips the deadline missed entirely and those after are on schedule again
+void testOverrun() {
+    bool pending {false};
+    FrameScheduler frameScheduler {"overrun", 25.0f,
+	[&pending](){pending = true;}};
+    int64_t const start {now};
+    auto const starts {run(frameScheduler, 20, [](size_t f){
+	return 10 == f ? 5 * period / 2 : period / 4;
+    }, pending)};
+    for (size_t f {0}; f <= 10; ++f) {
+	check(start + static_cast<int64_t>(f + 1) * period == starts[f]);
+    }
+    // frame 10 ended 2.5 periods after it started
+    check(starts[10] + 5 * period / 2 == starts[11]);
+    for (size_t f {12}; f < starts.size(); ++f) {
+	check(start + static_cast<int64_t>(f + 2) * period == starts[f]);
+    }
+    check(1 == frameScheduler.overruns());
+    check(1 == frameScheduler.skips());
+}
+
+// frames that always take longer than a period follow one another
+// (never queued faster than they are done)
+// and each skips the deadlines that it missed entirely
+void testAlwaysOverrun() {
+    bool pending {false};
+    FrameScheduler frameScheduler {"alwaysOverrun", 25.0f,
+	[&pending](){pending = true;}};
+    uint32_t constexpr cost {5 * period / 2};
+    auto const starts {run(frameScheduler, 100, [](size_t){
+	return cost;
+    }, pending)};
+    for (size_t f {1}; f < starts.size(); ++f) {
+	check(cost == starts[f] - starts[f - 1]);
+    }
+    check(starts.size() == frameScheduler.overruns());	// the last too
+    // overruns alternate skipping 1 and 2 deadlines
+    check(frameScheduler.skips() > frameScheduler.overruns());
+    check(frameScheduler.skips() < 2 * frameScheduler.overruns());
+}
+
+}
+
+int main() {
+    testOnSchedule();
+    testOverrun();
+    testAlwaysOverrun();
+    return checkFailures();
+}
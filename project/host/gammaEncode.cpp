@@ -0,0 +1,36 @@
+// GammaEncode12 against a float reference
+
+#include <cmath>
+#include <initializer_list>
+
+#include "GammaEncode.h"
+
+#include "check.h"
+
+static int reference(int value, float gamma) {
+    if (0 >= value) return 0;
+    int const max {GammaEncode12::max};
+    if (max < value) value = max;
+    int const e {static_cast<int>(
+	0.5f + max * std::pow(static_cast<float>(value) / max, gamma))};
+    return e ? e : 1;
+}
+
+int main() {
+    GammaEncode12 gammaEncode {2.0f};
+    for (float gamma: {0.5f, 1.0f, 2.0f, 2.2f, 3.0f}) {
+	gammaEncode.gamma(gamma);
+	int previous {0};
+	for (int value {-2}; value <= GammaEncode12::max + 2; ++value) {
+	    int const e {gammaEncode(static_cast<int16_t>(value))};
+	    check(e == reference(value, gamma));
+	    check(previous <= e);			// monotonic
+	    check(!(0 < value) == !(0 < e));	// non-zero stays non-zero
+	    previous = e;
+	}
+	check(0 == gammaEncode(std::numeric_limits<int16_t>::min()));
+	check(GammaEncode12::max
+	    == gammaEncode(std::numeric_limits<int16_t>::max()));
+    }
+    return checkFailures();
+}
@@ -0,0 +1,97 @@
+// gammaTime measures, on the host, the time that gamma encoding
+// a golden frame of 1024 LEDs (into wiring order) takes
+// before (a pow for each non-zero channel, as GoldenArtTask did)
+// and after (a GammaEncode12 lookup, as it does now, fused with encoding).
+// both must encode the same.
+// the target (without a fast pow) gains much more than the host.
+//
+//	./gammaTime [frames]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "APA102.h"
+#include "GammaEncode.h"
+
+#include "check.h"
+
+using APA102::LED;
+
+static size_t constexpr ledCount {1024};
+
+// before: gamma applied with pow
+static void encodePow(uint32_t * encodings, LED<int16_t> const * leds,
+    float gamma, uint16_t const * layout)
+{
+    for (size_t i {0}; i < ledCount; ++i) {
+	LED<int16_t> const & e {leds[i]};
+	int16_t ps[3] {
+	    e.part.red,
+	    e.part.green,
+	    e.part.blue,
+	};
+	for (auto & p: ps) {
+	    if (p) {
+		constexpr int16_t max {0xfff};
+		auto out {static_cast<int16_t>(
+		    0.5f + max * std::pow(static_cast<float>(p) / max, gamma))};
+		if (!out) out = 1;
+		p = out;
+	    }
+	}
+	encodings[layout[i]] = LED<int16_t>(ps[0], ps[1], ps[2]);
+    }
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 1000u};
+
+    using Clock = std::chrono::steady_clock;
+
+    // a quarter of the channels are off, as is typical of a clock face
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> part {-0x400, GammaEncode12::max};
+    static LED<int16_t> leds[ledCount];
+    static uint16_t layout[ledCount];
+    for (size_t i {0}; i < ledCount; ++i) {
+	auto const p = [&rng, &part](){
+	    return static_cast<int16_t>(std::max(0, part(rng)));
+	};
+	leds[i] = {p(), p(), p()};
+	layout[i] = (i * 7) % ledCount;
+    }
+
+    float const gamma {2.2f};
+    GammaEncode12 const gammaEncode {gamma};
+    static uint32_t before[ledCount], after[ledCount];
+
+    Clock::duration pow {0}, table {0};
+    for (unsigned frame {0}; frame < count; ++frame) {
+	// vary a channel so that nothing is hoisted out of the loop
+	leds[frame % ledCount].part.red = frame % (GammaEncode12::max + 1);
+	auto const start {Clock::now()};
+	encodePow(before, leds, gamma, layout);
+	auto const encoding {Clock::now()};
+	APA102::encode(after, leds, ledCount, gammaEncode, layout);
+	auto const end {Clock::now()};
+	pow += encoding - start;
+	table += end - encoding;
+	for (size_t i {0}; i < ledCount; ++i) check(before[i] == after[i]);
+    }
+
+    auto const perFrame = [count](Clock::duration duration) {
+	return count ? std::chrono::duration<double, std::micro>(duration)
+	    .count() / count : 0.0;
+    };
+    std::printf("frames %u microseconds per frame: pow %.1f table %.1f"
+	" (%.1f times faster)\n",
+	count, perFrame(pow), perFrame(table),
+	table.count() ? static_cast<double>(pow.count()) / table.count() : 0.0);
+    return checkFailures();
+}
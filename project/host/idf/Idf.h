@@ -0,0 +1,25 @@
+#pragma once
+
+// host only: what a host program may ask of the host stand-ins for esp-idf
+// (beyond the esp-idf and FreeRTOS interfaces that they stand in for).
+
+#include <cstddef>
+
+#include "freertos/FreeRTOS.h"
+
+namespace Idf {
+
+/// make the calling thread (one not created as a task) a task
+/// that pcTaskGetTaskName and xPortGetCoreID will know
+void becomeTask(char const * name, UBaseType_t priority, BaseType_t core);
+
+/// add a data partition, labeled label, that is found
+/// (by esp_partition_find_first) and mapped (by esp_partition_mmap)
+/// where data is
+void addPartition(char const * label, void const * data, size_t size);
+
+/// NVS writes (sets and erases) and commits, so far
+unsigned nvsWrites();
+unsigned nvsCommits();
+
+}
@@ -0,0 +1,151 @@
+// host stand-ins for esp-idf system, logging and partition functions.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+#include "Idf.h"
+
+char const * esp_err_to_name(esp_err_t code) {
+    switch (code) {
+    case ESP_OK:			return "ESP_OK";
+    case ESP_FAIL:			return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:		return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:		return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:		return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:		return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:		return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:		return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:		return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_NVS_NOT_INITIALIZED:	return "ESP_ERR_NVS_NOT_INITIALIZED";
+    case ESP_ERR_NVS_NOT_FOUND:		return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_INVALID_HANDLE:	return "ESP_ERR_NVS_INVALID_HANDLE";
+    case ESP_ERR_NVS_INVALID_LENGTH:	return "ESP_ERR_NVS_INVALID_LENGTH";
+    default:				return "UNKNOWN ERROR";
+    }
+}
+
+static esp_log_level_t logLevel() {
+    char const * const level {std::getenv("ARTLIGHT_LOG")};
+    if (!level) return ESP_LOG_WARN;
+    switch (*level) {
+    case 'N': return ESP_LOG_NONE;
+    case 'E': return ESP_LOG_ERROR;
+    case 'W': return ESP_LOG_WARN;
+    case 'I': return ESP_LOG_INFO;
+    case 'D': return ESP_LOG_DEBUG;
+    default:  return ESP_LOG_VERBOSE;
+    }
+}
+
+bool esp_log_enabled(esp_log_level_t level) {
+    static esp_log_level_t const enabled {logLevel()};
+    return level <= enabled;
+}
+
+void esp_log_write(esp_log_level_t, char const *, char const * format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    std::vfprintf(stderr, format, arguments);
+    va_end(arguments);
+}
+
+static std::mutex shutdownMutex;
+static std::list<shutdown_handler_t> shutdownHandlers;
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) {
+    std::lock_guard<std::mutex> lock(shutdownMutex);
+    shutdownHandlers.push_back(handler);
+    return ESP_OK;
+}
+
+esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t handler) {
+    std::lock_guard<std::mutex> lock(shutdownMutex);
+    auto const it {std::find(shutdownHandlers.begin(), shutdownHandlers.end(),
+	handler)};
+    if (shutdownHandlers.end() == it) return ESP_ERR_INVALID_STATE;
+    shutdownHandlers.erase(it);
+    return ESP_OK;
+}
+
+void esp_restart() {
+    std::list<shutdown_handler_t> handlers;
+    {
+	std::lock_guard<std::mutex> lock(shutdownMutex);
+	handlers.swap(shutdownHandlers);
+    }
+    for (auto handler: handlers) handler();
+    std::exit(0);
+}
+
+// SmoothTime reads the (private) boot time of our modified newlib time.c.
+// on the host, the system clock is not adjusted beneath us
+// so this is when the system clock says we booted.
+extern "C" int64_t get_adjusted_boot_time() {
+    static int64_t const bootTime {
+	std::chrono::duration_cast<std::chrono::microseconds>(
+	    std::chrono::system_clock::now().time_since_epoch()).count()
+	- esp_timer_get_time()};
+    return bootTime;
+}
+
+static std::mutex partitionMutex;
+static std::list<esp_partition_t> partitions;
+
+void Idf::addPartition(char const * label, void const * data, size_t size) {
+    esp_partition_t partition {};
+    partition.type	= ESP_PARTITION_TYPE_DATA;
+    partition.subtype	= ESP_PARTITION_SUBTYPE_ANY;
+    partition.size	= size;
+    std::strncpy(partition.label, label, sizeof partition.label - 1);
+    partition.data	= data;
+    std::lock_guard<std::mutex> lock(partitionMutex);
+    partitions.push_back(partition);
+}
+
+esp_partition_t const * esp_partition_find_first(
+    esp_partition_type_t	type,
+    esp_partition_subtype_t	subtype,
+    char const *		label)
+{
+    std::lock_guard<std::mutex> lock(partitionMutex);
+    for (auto const & partition: partitions) {
+	if (type == partition.type
+		&& (ESP_PARTITION_SUBTYPE_ANY == subtype
+		    || subtype == partition.subtype)
+		&& (!label || !std::strcmp(label, partition.label))) {
+	    return &partition;
+	}
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_mmap(
+    esp_partition_t const *	partition,
+    size_t			offset,
+    size_t			size,
+    spi_flash_mmap_memory_t,
+    void const **		out,
+    spi_flash_mmap_handle_t *	handle)
+{
+    if (offset + size > partition->size) return ESP_ERR_INVALID_ARG;
+    *out = static_cast<uint8_t const *>(partition->data) + offset;
+    *handle = 0;
+    return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t) {}
@@ -0,0 +1,160 @@
+// host stand-in for esp_timer.
+// time is that of the steady clock since the process started (boot).
+// callbacks are run, in order, by an esp_timer thread
+// (as they are by the esp_timer task with ESP_TIMER_TASK dispatch).
+// a deleted timer is only freed by that thread
+// (never while its callback runs).
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "esp_time_impl.h"
+#include "esp_timer.h"
+
+#include "Idf.h"
+
+using Clock = std::chrono::steady_clock;
+
+static Clock::time_point const boot {Clock::now()};
+
+int64_t esp_timer_get_time() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+	Clock::now() - boot).count();
+}
+
+uint64_t esp_time_impl_get_time_since_boot() {
+    return esp_timer_get_time();
+}
+
+struct esp_timer {
+    esp_timer_cb_t	callback;
+    void *		arg;
+    std::string		name;
+    bool		armed;
+    bool		deleted;
+    int64_t		due;		///< microseconds since boot
+    uint64_t		period;		///< microseconds, if periodic
+};
+
+namespace {
+
+class Dispatcher {
+private:
+    std::mutex			mutex;
+    std::condition_variable	changed;
+    std::list<esp_timer *>	timers;
+    std::thread			thread;
+
+    void run() {
+	Idf::becomeTask("esp_timer", 22, 0);
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+	    timers.remove_if([](esp_timer * timer){
+		if (!timer->deleted) return false;
+		delete timer;
+		return true;
+	    });
+	    auto const next {std::min_element(timers.begin(), timers.end(),
+		[](esp_timer const * a, esp_timer const * b){
+		    return a->armed && (!b->armed || a->due < b->due);
+		})};
+	    if (timers.end() == next || !(*next)->armed) {
+		changed.wait(lock);
+		continue;
+	    }
+	    esp_timer * const timer {*next};
+	    int64_t const now {esp_timer_get_time()};
+	    if (now < timer->due) {
+		changed.wait_until(lock,
+		    boot + std::chrono::microseconds(timer->due));
+		continue;
+	    }
+	    if (timer->period) {
+		timer->due += timer->period;
+	    } else {
+		timer->armed = false;
+	    }
+	    lock.unlock();
+	    timer->callback(timer->arg);
+	    lock.lock();
+	}
+    }
+
+public:
+    Dispatcher() : thread {[this](){run();}} {
+	thread.detach();
+    }
+
+    template <typename Command>
+    esp_err_t command(Command const & command_) {
+	std::lock_guard<std::mutex> lock(mutex);
+	esp_err_t const result {command_()};
+	changed.notify_one();
+	return result;
+    }
+
+    void add(esp_timer * timer) {
+	command([this, timer](){timers.push_back(timer); return ESP_OK;});
+    }
+};
+
+Dispatcher & dispatcher() {
+    // never destroyed: its thread may outlive main
+    static Dispatcher * const dispatcher_ {new Dispatcher};
+    return *dispatcher_;
+}
+
+}
+
+esp_err_t esp_timer_create(esp_timer_create_args_t const * args,
+    esp_timer_handle_t * handle)
+{
+    if (!args || !args->callback || !handle) return ESP_ERR_INVALID_ARG;
+    esp_timer * const timer {new esp_timer {args->callback, args->arg,
+	args->name ? args->name : "", false, false, 0, 0}};
+    dispatcher().add(timer);
+    *handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t start(esp_timer_handle_t timer, uint64_t timeout,
+    uint64_t period)
+{
+    return dispatcher().command([timer, timeout, period](){
+	if (timer->armed) return ESP_ERR_INVALID_STATE;
+	timer->armed = true;
+	timer->due = esp_timer_get_time() + timeout;
+	timer->period = period;
+	return ESP_OK;
+    });
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout) {
+    return start(timer, timeout, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return start(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    return dispatcher().command([timer](){
+	if (!timer->armed) return ESP_ERR_INVALID_STATE;
+	timer->armed = false;
+	return ESP_OK;
+    });
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    return dispatcher().command([timer](){
+	if (timer->armed) return ESP_ERR_INVALID_STATE;
+	timer->deleted = true;
+	return ESP_OK;
+    });
+}
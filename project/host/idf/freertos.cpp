@@ -0,0 +1,371 @@
+// host stand-in for the esp-idf port of FreeRTOS.
+// a task is a (detached) std::thread that runs until its function returns.
+// a queue (or semaphore) is guarded by a std::mutex
+// and waited on with std::condition_variables.
+// timer callbacks and pended functions are run, in order,
+// by a timer daemon thread (as they are by the FreeRTOS timer daemon task).
+// like FreeRTOS, none of these allocate once they are created
+// so that they do not add to the allocations counted by a host program.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+
+#include "Idf.h"
+
+using Clock = std::chrono::steady_clock;
+
+static Clock::duration durationOf(TickType_t ticks) {
+    return std::chrono::milliseconds(ticks * portTICK_PERIOD_MS);
+}
+
+struct tskTaskControlBlock {
+    std::string		name;
+    UBaseType_t		priority;
+    BaseType_t		core;
+};
+
+// the task that is not created (app_main's)
+static tskTaskControlBlock mainTask {"main", 1, 0};
+static thread_local tskTaskControlBlock * currentTask {&mainTask};
+
+static tskTaskControlBlock * taskOf(TaskHandle_t task) {
+    return task ? task : currentTask;
+}
+
+BaseType_t xPortGetCoreID() {
+    BaseType_t const core {currentTask->core};
+    return tskNO_AFFINITY == core ? 0 : core;
+}
+
+BaseType_t xTaskCreatePinnedToCore(
+    TaskFunction_t	function,
+    char const *	name,
+    uint32_t,
+    void *		parameters,
+    UBaseType_t		priority,
+    TaskHandle_t *	createdTask,
+    BaseType_t		core)
+{
+    tskTaskControlBlock * const task
+	{new tskTaskControlBlock {name, priority, core}};
+    if (createdTask) *createdTask = task;
+    std::thread([function, parameters, task](){
+	currentTask = task;
+	function(parameters);
+	delete task;
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task && task != currentTask) {
+	std::fprintf(stderr, "vTaskDelete of another task is not supported\n");
+	std::abort();
+    }
+    // the task will end when its function returns
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(durationOf(ticks));
+}
+
+char * pcTaskGetTaskName(TaskHandle_t task) {
+    return &taskOf(task)->name[0];
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    return taskOf(task)->priority;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask;
+}
+
+void Idf::becomeTask(char const * name, UBaseType_t priority, BaseType_t core)
+{
+    // never deleted: the thread is not a task that returns
+    currentTask = new tskTaskControlBlock {name, priority, core};
+}
+
+struct QueueDefinition {
+    UBaseType_t const		length;
+    UBaseType_t const		itemSize;
+    std::mutex			mutex;
+    std::condition_variable	sent;
+    std::condition_variable	received;
+    std::vector<char>		items;	///< ring of length items
+    UBaseType_t			begin;
+    UBaseType_t			size;
+
+    QueueDefinition(UBaseType_t length_, UBaseType_t itemSize_)
+    :
+	length		(length_),
+	itemSize	(itemSize_),
+	items		(length * itemSize),
+	begin		(0),
+	size		(0)
+    {}
+
+    bool wait(std::unique_lock<std::mutex> & lock,
+	std::condition_variable & condition,
+	TickType_t ticks,
+	std::function<bool()> const & ready)
+    {
+	if (portMAX_DELAY == ticks) {
+	    condition.wait(lock, ready);
+	    return true;
+	}
+	return condition.wait_for(lock, durationOf(ticks), ready);
+    }
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    return new QueueDefinition(length, itemSize);
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, void const * item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!queue->wait(lock, queue->received, wait, [queue](){
+	    return queue->size < queue->length;
+	})) {
+	return pdFAIL;
+    }
+    UBaseType_t const end {(queue->begin + queue->size++) % queue->length};
+    if (queue->itemSize) {
+	std::memcpy(&queue->items[end * queue->itemSize], item,
+	    queue->itemSize);
+    }
+    queue->sent.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, void const * item,
+    BaseType_t * woken)
+{
+    if (woken) *woken = pdFALSE;
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void * item, TickType_t wait) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!queue->wait(lock, queue->sent, wait, [queue](){
+	    return 0 < queue->size;
+	})) {
+	return pdFAIL;
+    }
+    if (queue->itemSize) {
+	std::memcpy(item, &queue->items[queue->begin * queue->itemSize],
+	    queue->itemSize);
+    }
+    queue->begin = (queue->begin + 1) % queue->length;
+    --queue->size;
+    queue->received.notify_one();
+    return pdPASS;
+}
+
+struct tmrTimerControl {
+    std::string			name;
+    TickType_t			period;
+    UBaseType_t const		autoReload;
+    void *			id;
+    TimerCallbackFunction_t	callback;
+    bool			active;
+    bool			deleted;
+    Clock::time_point		expiry;
+};
+
+namespace {
+
+struct PendedCall {
+    PendedFunction_t	function;
+    void *		parameter1;
+    uint32_t		parameter2;
+};
+
+/// the timer daemon task.
+/// commands are done at once (not queued to it)
+/// but a timer is only freed by it (never while its callback runs).
+/// pended calls are run in the order that they were pended
+/// from a vector that is swapped with (and so reuses the memory of)
+/// the one that was run before.
+class TimerDaemon {
+private:
+    std::mutex				mutex;
+    std::condition_variable		changed;
+    std::list<tmrTimerControl *>	timers;
+    std::vector<PendedCall>		pended;
+    std::vector<PendedCall>		running;
+    std::thread				thread;
+
+    void run() {
+	Idf::becomeTask("Tmr Svc", 1, 0);
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+	    if (!pended.empty()) {
+		running.swap(pended);
+		lock.unlock();
+		for (PendedCall const & call: running) {
+		    call.function(call.parameter1, call.parameter2);
+		}
+		running.clear();
+		lock.lock();
+		continue;
+	    }
+	    timers.remove_if([](tmrTimerControl * timer){
+		if (!timer->deleted) return false;
+		delete timer;
+		return true;
+	    });
+	    auto const next {std::min_element(timers.begin(), timers.end(),
+		[](tmrTimerControl const * a, tmrTimerControl const * b){
+		    return a->active
+			&& (!b->active || a->expiry < b->expiry);
+		})};
+	    if (timers.end() == next || !(*next)->active) {
+		changed.wait(lock);
+		continue;
+	    }
+	    tmrTimerControl * const timer {*next};
+	    if (Clock::now() < timer->expiry) {
+		changed.wait_until(lock, timer->expiry);
+		continue;
+	    }
+	    if (timer->autoReload) {
+		timer->expiry += durationOf(timer->period);
+	    } else {
+		timer->active = false;
+	    }
+	    lock.unlock();
+	    timer->callback(timer);
+	    lock.lock();
+	}
+    }
+
+public:
+    TimerDaemon() {
+	pended.reserve(16);
+	running.reserve(16);
+	thread = std::thread([this](){run();});
+	thread.detach();
+    }
+
+    template <typename Command>
+    BaseType_t command(Command const & command_) {
+	std::lock_guard<std::mutex> lock(mutex);
+	command_();
+	changed.notify_one();
+	return pdPASS;
+    }
+
+    void add(tmrTimerControl * timer) {
+	command([this, timer](){timers.push_back(timer);});
+    }
+
+    BaseType_t pend(PendedCall const & call) {
+	return command([this, &call](){pended.push_back(call);});
+    }
+};
+
+TimerDaemon & timerDaemon() {
+    // never destroyed: its thread may outlive main
+    static TimerDaemon * const daemon {new TimerDaemon};
+    return *daemon;
+}
+
+}
+
+TimerHandle_t xTimerCreate(
+    char const *		name,
+    TickType_t			period,
+    UBaseType_t			autoReload,
+    void *			id,
+    TimerCallbackFunction_t	callback)
+{
+    tmrTimerControl * const timer {new tmrTimerControl {
+	name, period, autoReload, id, callback, false, false, {}}};
+    timerDaemon().add(timer);
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t) {
+    return timerDaemon().command([timer](){
+	timer->active = true;
+	timer->expiry = Clock::now() + durationOf(timer->period);
+    });
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t) {
+    return timerDaemon().command([timer](){timer->active = false;});
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period,
+    TickType_t)
+{
+    return timerDaemon().command([timer, period](){
+	timer->period = period;
+	timer->active = true;
+	timer->expiry = Clock::now() + durationOf(period);
+    });
+}
+
+TickType_t xTimerGetPeriod(TimerHandle_t timer) {
+    TickType_t period;
+    timerDaemon().command([timer, &period](){period = timer->period;});
+    return period;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer) {
+    bool active;
+    timerDaemon().command([timer, &active](){active = timer->active;});
+    return active ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t) {
+    return timerDaemon().command([timer](){
+	timer->active = false;
+	timer->deleted = true;
+    });
+}
+
+void * pvTimerGetTimerID(TimerHandle_t timer) {
+    void * id;
+    timerDaemon().command([timer, &id](){id = timer->id;});
+    return id;
+}
+
+void vTimerSetTimerID(TimerHandle_t timer, void * id) {
+    timerDaemon().command([timer, id](){timer->id = id;});
+}
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t function,
+    void * parameter1, uint32_t parameter2, TickType_t)
+{
+    return timerDaemon().pend({function, parameter1, parameter2});
+}
+
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function,
+    void * parameter1, uint32_t parameter2, BaseType_t * woken)
+{
+    if (woken) *woken = pdFALSE;
+    return xTimerPendFunctionCall(function, parameter1, parameter2, 0);
+}
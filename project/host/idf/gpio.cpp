@@ -0,0 +1,106 @@
+// host stand-in for the esp-idf GPIO driver.
+// levels set are remembered (and gotten)
+// but nothing else is and there are no interrupts.
+
+#include <atomic>
+
+#include "driver/gpio.h"
+
+static std::atomic<int> level[GPIO_NUM_MAX];
+
+static esp_err_t valid(gpio_num_t gpio_num) {
+    return 0 <= gpio_num && gpio_num < GPIO_NUM_MAX
+	? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_config(gpio_config_t const * config) {
+    return config->pin_bit_mask >> GPIO_NUM_MAX ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level_) {
+    if (esp_err_t const e = valid(gpio_num)) return e;
+    level[gpio_num] = level_ ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    return valid(gpio_num) ? 0 : level[gpio_num].load();
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_pullup_en(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_pullup_dis(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_pulldown_en(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_pulldown_dis(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_set_drive_capability(gpio_num_t gpio_num, gpio_drive_cap_t) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
+
+void gpio_iomux_in(uint32_t, uint32_t) {}
+
+void gpio_iomux_out(uint8_t, int, bool) {}
+
+esp_err_t gpio_install_isr_service(int) {
+    return ESP_OK;
+}
+
+void gpio_uninstall_isr_service() {}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t, void *) {
+    return valid(gpio_num);
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num) {
+    return valid(gpio_num);
+}
@@ -0,0 +1,148 @@
+// host stand-in for the esp-idf LEDC driver.
+// timer frequencies and channel duties (and hpoints) are remembered
+// (and gotten). a fade completes at once.
+
+#include <atomic>
+
+#include "driver/ledc.h"
+
+static std::atomic<uint32_t> freq[LEDC_SPEED_MODE_MAX][LEDC_TIMER_MAX];
+static std::atomic<uint32_t> duty[LEDC_SPEED_MODE_MAX][LEDC_CHANNEL_MAX];
+static std::atomic<int> hpoint[LEDC_SPEED_MODE_MAX][LEDC_CHANNEL_MAX];
+
+static esp_err_t valid(ledc_mode_t speed_mode, ledc_timer_t timer_num) {
+    return 0 <= speed_mode && speed_mode < LEDC_SPEED_MODE_MAX
+	    && 0 <= timer_num && timer_num < LEDC_TIMER_MAX
+	? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t valid(ledc_mode_t speed_mode, ledc_channel_t channel) {
+    return 0 <= speed_mode && speed_mode < LEDC_SPEED_MODE_MAX
+	    && 0 <= channel && channel < LEDC_CHANNEL_MAX
+	? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_fade_func_install(int) {
+    return ESP_OK;
+}
+
+void ledc_fade_func_uninstall() {}
+
+esp_err_t ledc_timer_config(ledc_timer_config_t const * config) {
+    return ledc_set_freq(config->speed_mode, config->timer_num,
+	config->freq_hz);
+}
+
+esp_err_t ledc_set_freq(ledc_mode_t speed_mode, ledc_timer_t timer_num,
+    uint32_t freq_hz)
+{
+    if (esp_err_t const e = valid(speed_mode, timer_num)) return e;
+    freq[speed_mode][timer_num] = freq_hz;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_freq(ledc_mode_t speed_mode, ledc_timer_t timer_num) {
+    return valid(speed_mode, timer_num) ? 0 : freq[speed_mode][timer_num].load();
+}
+
+esp_err_t ledc_timer_rst(ledc_mode_t speed_mode, ledc_timer_t timer_num) {
+    return valid(speed_mode, timer_num);
+}
+
+esp_err_t ledc_timer_pause(ledc_mode_t speed_mode, ledc_timer_t timer_num) {
+    return valid(speed_mode, timer_num);
+}
+
+esp_err_t ledc_timer_resume(ledc_mode_t speed_mode, ledc_timer_t timer_num) {
+    return valid(speed_mode, timer_num);
+}
+
+esp_err_t ledc_channel_config(ledc_channel_config_t const * config) {
+    return ledc_set_duty_with_hpoint(config->speed_mode, config->channel,
+	config->duty, config->hpoint);
+}
+
+esp_err_t ledc_bind_channel_timer(ledc_mode_t speed_mode,
+    ledc_channel_t channel, ledc_timer_t timer_num)
+{
+    if (esp_err_t const e = valid(speed_mode, channel)) return e;
+    return valid(speed_mode, timer_num);
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel) {
+    return valid(speed_mode, channel);
+}
+
+esp_err_t ledc_stop(ledc_mode_t speed_mode, ledc_channel_t channel,
+    uint32_t)
+{
+    return valid(speed_mode, channel);
+}
+
+esp_err_t ledc_set_duty_with_hpoint(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t duty_, uint32_t hpoint_)
+{
+    if (esp_err_t const e = valid(speed_mode, channel)) return e;
+    duty[speed_mode][channel] = duty_;
+    hpoint[speed_mode][channel] = hpoint_;
+    return ESP_OK;
+}
+
+int ledc_get_hpoint(ledc_mode_t speed_mode, ledc_channel_t channel) {
+    return valid(speed_mode, channel) ? -1 : hpoint[speed_mode][channel].load();
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel,
+    uint32_t duty_)
+{
+    if (esp_err_t const e = valid(speed_mode, channel)) return e;
+    duty[speed_mode][channel] = duty_;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel) {
+    return valid(speed_mode, channel) ? 0 : duty[speed_mode][channel].load();
+}
+
+esp_err_t ledc_set_fade(ledc_mode_t speed_mode, ledc_channel_t channel,
+    uint32_t duty_, ledc_duty_direction_t, uint32_t, uint32_t, uint32_t)
+{
+    return ledc_set_duty(speed_mode, channel, duty_);
+}
+
+esp_err_t ledc_set_fade_with_step(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, uint32_t, uint32_t)
+{
+    return ledc_set_duty(speed_mode, channel, target_duty);
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, int)
+{
+    return ledc_set_duty(speed_mode, channel, target_duty);
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel,
+    ledc_fade_mode_t)
+{
+    return valid(speed_mode, channel);
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t duty_, uint32_t hpoint_)
+{
+    return ledc_set_duty_with_hpoint(speed_mode, channel, duty_, hpoint_);
+}
+
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, uint32_t, ledc_fade_mode_t)
+{
+    return ledc_set_duty(speed_mode, channel, target_duty);
+}
+
+esp_err_t ledc_set_fade_step_and_start(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, uint32_t, uint32_t,
+    ledc_fade_mode_t)
+{
+    return ledc_set_duty(speed_mode, channel, target_duty);
+}
@@ -0,0 +1,134 @@
+// host stand-in for esp-idf NVS.
+// each namespace maps keys to strings or blobs (both kept as std::string)
+// in memory, for the life of the program.
+// like esp-idf NVS, a write is effective at once (commit only makes sure).
+// writes (sets and erases) and commits are counted (see Idf.h).
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nvs.h"
+
+#include "Idf.h"
+
+namespace {
+
+struct Item {
+    bool		blob;
+    std::string		value;
+};
+
+using Namespace = std::map<std::string, Item>;
+
+std::mutex mutex;
+std::map<std::string, Namespace> namespaces;
+std::vector<Namespace *> handles;	// [handle - 1], nullptr if closed
+unsigned writes {0};
+unsigned commits {0};
+
+// the namespace of handle (with mutex held), nullptr if none
+Namespace * namespaceOf(nvs_handle_t handle) {
+    return handle && handle <= handles.size() ? handles[handle - 1] : nullptr;
+}
+
+esp_err_t set(nvs_handle_t handle, char const * key, bool blob,
+    char const * value, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Namespace * const space {namespaceOf(handle)};
+    if (!space) return ESP_ERR_NVS_INVALID_HANDLE;
+    (*space)[key] = {blob, std::string(value, length)};
+    ++writes;
+    return ESP_OK;
+}
+
+esp_err_t get(nvs_handle_t handle, char const * key, bool blob,
+    char * value, size_t * length, size_t terminator)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Namespace * const space {namespaceOf(handle)};
+    if (!space) return ESP_ERR_NVS_INVALID_HANDLE;
+    auto const it {space->find(key)};
+    if (space->end() == it || blob != it->second.blob) {
+	return ESP_ERR_NVS_NOT_FOUND;
+    }
+    std::string const & item {it->second.value};
+    if (value) {
+	if (*length < item.size() + terminator) {
+	    return ESP_ERR_NVS_INVALID_LENGTH;
+	}
+	std::memcpy(value, item.data(), item.size());
+	if (terminator) value[item.size()] = 0;
+    }
+    *length = item.size() + terminator;
+    return ESP_OK;
+}
+
+}
+
+esp_err_t nvs_open(char const * name, nvs_open_mode_t,
+    nvs_handle_t * out_handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    handles.push_back(&namespaces[name]);
+    *out_handle = handles.size();
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (namespaceOf(handle)) handles[handle - 1] = nullptr;
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, char const * key,
+    char const * value)
+{
+    return set(handle, key, false, value, std::strlen(value));
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, char const * key,
+    char * out_value, size_t * length)
+{
+    return get(handle, key, false, out_value, length, 1);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, char const * key,
+    void const * value, size_t length)
+{
+    return set(handle, key, true, static_cast<char const *>(value), length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, char const * key,
+    void * out_value, size_t * length)
+{
+    return get(handle, key, true, static_cast<char *>(out_value), length, 0);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, char const * key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Namespace * const space {namespaceOf(handle)};
+    if (!space) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!space->erase(key)) return ESP_ERR_NVS_NOT_FOUND;
+    ++writes;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!namespaceOf(handle)) return ESP_ERR_NVS_INVALID_HANDLE;
+    ++commits;
+    return ESP_OK;
+}
+
+unsigned Idf::nvsWrites() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writes;
+}
+
+unsigned Idf::nvsCommits() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return commits;
+}
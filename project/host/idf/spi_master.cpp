@@ -0,0 +1,145 @@
+// host stand-in for the esp-idf SPI master driver.
+// each device has a thread that transmits the transactions queued for it,
+// in order, each in the time that it would take at the device's clock speed.
+// its pre_cb and post_cb are called from this thread (as if from the ISR).
+// results are gotten in order, as they are done.
+// no more than queue_size transactions are queued (or done) so these are
+// kept in vectors reserved for that many, which are not reallocated.
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "driver/spi_master.h"
+
+#include "Idf.h"
+
+struct spi_device_t {
+    spi_host_device_t const			host;
+    spi_device_interface_config_t const		config;
+    std::mutex					mutex;
+    std::condition_variable			changed;
+    std::vector<spi_transaction_t *>		queued;
+    std::vector<spi_transaction_t *>		done;
+    bool					removed;
+    std::thread					thread;
+
+    spi_device_t(spi_host_device_t host_,
+	spi_device_interface_config_t const & config_)
+    :
+	host	(host_),
+	config	(config_),
+	removed	(false)
+    {
+	queued.reserve(config.queue_size);
+	done.reserve(config.queue_size);
+	thread = std::thread([this](){run();});
+    }
+
+    bool wait(std::unique_lock<std::mutex> & lock, TickType_t ticks,
+	std::function<bool()> const & ready)
+    {
+	if (portMAX_DELAY == ticks) {
+	    changed.wait(lock, ready);
+	    return true;
+	}
+	return changed.wait_for(lock,
+	    std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+    }
+
+    void run() {
+	Idf::becomeTask("spi", 24, 0);
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+	    changed.wait(lock, [this](){return removed || !queued.empty();});
+	    if (queued.empty()) return;
+	    spi_transaction_t * const transaction {queued.front()};
+	    lock.unlock();
+	    if (config.pre_cb) config.pre_cb(transaction);
+	    if (int const hz = config.clock_speed_hz) {
+		std::this_thread::sleep_for(std::chrono::nanoseconds(
+		    transaction->length * 1000000000ull / hz));
+	    }
+	    if (config.post_cb) config.post_cb(transaction);
+	    lock.lock();
+	    queued.erase(queued.begin());
+	    done.push_back(transaction);
+	    changed.notify_all();
+	}
+    }
+
+    ~spi_device_t() {
+	{
+	    std::lock_guard<std::mutex> lock(mutex);
+	    removed = true;
+	    changed.notify_all();
+	}
+	thread.join();
+    }
+};
+
+static bool busInitialized[3];
+
+esp_err_t spi_bus_initialize(spi_host_device_t host,
+    spi_bus_config_t const *, int)
+{
+    if (busInitialized[host]) return ESP_ERR_INVALID_STATE;
+    busInitialized[host] = true;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host) {
+    if (!busInitialized[host]) return ESP_ERR_INVALID_STATE;
+    busInitialized[host] = false;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host,
+    spi_device_interface_config_t const * config, spi_device_handle_t * handle)
+{
+    if (!busInitialized[host]) return ESP_ERR_INVALID_STATE;
+    *handle = new spi_device_t(host, *config);
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle) {
+    {
+	std::lock_guard<std::mutex> lock(handle->mutex);
+	if (!handle->queued.empty()) return ESP_ERR_INVALID_STATE;
+    }
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle,
+    spi_transaction_t * transaction, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(handle->mutex);
+    std::size_t const size {static_cast<std::size_t>(
+	handle->config.queue_size)};
+    if (!handle->wait(lock, wait, [handle, size](){
+	    return handle->queued.size() < size;
+	})) {
+	return ESP_ERR_TIMEOUT;
+    }
+    handle->queued.push_back(transaction);
+    handle->changed.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle,
+    spi_transaction_t ** transaction, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(handle->mutex);
+    if (!handle->wait(lock, wait, [handle](){
+	    return !handle->done.empty();
+	})) {
+	return ESP_ERR_TIMEOUT;
+    }
+    *transaction = handle->done.front();
+    handle->done.erase(handle->done.begin());
+    return ESP_OK;
+}
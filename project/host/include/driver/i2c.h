@@ -0,0 +1,76 @@
+#pragma once
+
+// host stand-in (see ../../idf/i2c.cpp).
+// every device acknowledges and command links take the time
+// that they would on the bus at its clock speed.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+
+#include "driver/gpio.h"
+
+typedef enum {
+    I2C_NUM_0,
+    I2C_NUM_1,
+    I2C_NUM_MAX,
+} i2c_port_t;
+
+typedef enum {
+    I2C_MODE_SLAVE,
+    I2C_MODE_MASTER,
+    I2C_MODE_MAX,
+} i2c_mode_t;
+
+typedef enum {
+    I2C_MASTER_ACK,
+    I2C_MASTER_NACK,
+    I2C_MASTER_LAST_NACK,
+    I2C_MASTER_ACK_MAX,
+} i2c_ack_type_t;
+
+typedef struct {
+    i2c_mode_t		mode;
+    int			sda_io_num;
+    gpio_pullup_t	sda_pullup_en;
+    int			scl_io_num;
+    gpio_pullup_t	scl_pullup_en;
+    union {
+	struct {
+	    uint32_t	clk_speed;
+	} master;
+	struct {
+	    uint8_t	addr_10bit_en;
+	    uint16_t	slave_addr;
+	} slave;
+    };
+} i2c_config_t;
+
+typedef struct i2c_cmd_link * i2c_cmd_handle_t;
+
+esp_err_t i2c_param_config(i2c_port_t port, i2c_config_t const * config);
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode,
+    size_t slaveReceiveBufferLength, size_t slaveTransmitBufferLength,
+    int interruptAllocationFlags);
+esp_err_t i2c_driver_delete(i2c_port_t port);
+
+i2c_cmd_handle_t i2c_cmd_link_create();
+void i2c_cmd_link_delete(i2c_cmd_handle_t command);
+esp_err_t i2c_master_start(i2c_cmd_handle_t command);
+esp_err_t i2c_master_stop(i2c_cmd_handle_t command);
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t command, uint8_t data,
+    bool ack);
+esp_err_t i2c_master_write(i2c_cmd_handle_t command, uint8_t * data,
+    size_t size, bool ack);
+esp_err_t i2c_master_read_byte(i2c_cmd_handle_t command, uint8_t * data,
+    i2c_ack_type_t ack);
+esp_err_t i2c_master_read(i2c_cmd_handle_t command, uint8_t * data,
+    size_t size, i2c_ack_type_t ack);
+esp_err_t i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t command,
+    TickType_t wait);
+
+int i2c_slave_write_buffer(i2c_port_t port, uint8_t const * data, int size,
+    TickType_t wait);
+int i2c_slave_read_buffer(i2c_port_t port, uint8_t * data, size_t size,
+    TickType_t wait);
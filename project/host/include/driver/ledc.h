@@ -0,0 +1,119 @@
+#pragma once
+
+// host stand-in (see ../../idf/ledc.cpp).
+// duties and frequencies are remembered and fades complete at once.
+
+#include <cstdint>
+
+#include "esp_err.h"
+
+#define APB_CLK_FREQ	(80 * 1000 * 1000)
+
+typedef enum {
+    LEDC_HIGH_SPEED_MODE,
+    LEDC_LOW_SPEED_MODE,
+    LEDC_SPEED_MODE_MAX,
+} ledc_mode_t;
+
+typedef enum {
+    LEDC_INTR_DISABLE,
+    LEDC_INTR_FADE_END,
+} ledc_intr_type_t;
+
+typedef enum {
+    LEDC_DUTY_DIR_DECREASE,
+    LEDC_DUTY_DIR_INCREASE,
+} ledc_duty_direction_t;
+
+typedef enum {
+    LEDC_AUTO_CLK,
+    LEDC_USE_REF_TICK,
+    LEDC_USE_APB_CLK,
+    LEDC_USE_RTC8M_CLK,
+} ledc_clk_cfg_t;
+
+typedef enum {
+    LEDC_TIMER_0, LEDC_TIMER_1, LEDC_TIMER_2, LEDC_TIMER_3,
+    LEDC_TIMER_MAX,
+} ledc_timer_t;
+
+typedef enum {
+    LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
+    LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7,
+    LEDC_CHANNEL_MAX,
+} ledc_channel_t;
+
+typedef enum {
+    LEDC_TIMER_1_BIT = 1, LEDC_TIMER_2_BIT, LEDC_TIMER_3_BIT,
+    LEDC_TIMER_4_BIT, LEDC_TIMER_5_BIT, LEDC_TIMER_6_BIT, LEDC_TIMER_7_BIT,
+    LEDC_TIMER_8_BIT, LEDC_TIMER_9_BIT, LEDC_TIMER_10_BIT,
+    LEDC_TIMER_11_BIT, LEDC_TIMER_12_BIT, LEDC_TIMER_13_BIT,
+    LEDC_TIMER_14_BIT, LEDC_TIMER_15_BIT, LEDC_TIMER_16_BIT,
+    LEDC_TIMER_17_BIT, LEDC_TIMER_18_BIT, LEDC_TIMER_19_BIT,
+    LEDC_TIMER_20_BIT,
+    LEDC_TIMER_BIT_MAX,
+} ledc_timer_bit_t;
+
+typedef enum {
+    LEDC_FADE_NO_WAIT,
+    LEDC_FADE_WAIT_DONE,
+    LEDC_FADE_MAX,
+} ledc_fade_mode_t;
+
+typedef struct {
+    ledc_mode_t		speed_mode;
+    ledc_timer_bit_t	duty_resolution;
+    ledc_timer_t	timer_num;
+    uint32_t		freq_hz;
+    ledc_clk_cfg_t	clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct {
+    int			gpio_num;
+    ledc_mode_t		speed_mode;
+    ledc_channel_t	channel;
+    ledc_intr_type_t	intr_type;
+    ledc_timer_t	timer_sel;
+    uint32_t		duty;
+    int			hpoint;
+} ledc_channel_config_t;
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags);
+void ledc_fade_func_uninstall();
+esp_err_t ledc_timer_config(ledc_timer_config_t const * config);
+esp_err_t ledc_set_freq(ledc_mode_t speed_mode, ledc_timer_t timer_num,
+    uint32_t freq_hz);
+uint32_t ledc_get_freq(ledc_mode_t speed_mode, ledc_timer_t timer_num);
+esp_err_t ledc_timer_rst(ledc_mode_t speed_mode, ledc_timer_t timer_num);
+esp_err_t ledc_timer_pause(ledc_mode_t speed_mode, ledc_timer_t timer_num);
+esp_err_t ledc_timer_resume(ledc_mode_t speed_mode, ledc_timer_t timer_num);
+esp_err_t ledc_channel_config(ledc_channel_config_t const * config);
+esp_err_t ledc_bind_channel_timer(ledc_mode_t speed_mode,
+    ledc_channel_t channel, ledc_timer_t timer_num);
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel);
+esp_err_t ledc_stop(ledc_mode_t speed_mode, ledc_channel_t channel,
+    uint32_t idle_level);
+esp_err_t ledc_set_duty_with_hpoint(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t duty, uint32_t hpoint);
+int ledc_get_hpoint(ledc_mode_t speed_mode, ledc_channel_t channel);
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel,
+    uint32_t duty);
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel);
+esp_err_t ledc_set_fade(ledc_mode_t speed_mode, ledc_channel_t channel,
+    uint32_t duty, ledc_duty_direction_t fade_direction, uint32_t step_num,
+    uint32_t duty_cycle_num, uint32_t duty_scale);
+esp_err_t ledc_set_fade_with_step(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, uint32_t scale,
+    uint32_t cycle_num);
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, int max_fade_time_ms);
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel,
+    ledc_fade_mode_t fade_mode);
+esp_err_t ledc_set_duty_and_update(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t duty, uint32_t hpoint);
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, uint32_t max_fade_time_ms,
+    ledc_fade_mode_t fade_mode);
+esp_err_t ledc_set_fade_step_and_start(ledc_mode_t speed_mode,
+    ledc_channel_t channel, uint32_t target_duty, uint32_t scale,
+    uint32_t cycle_num, ledc_fade_mode_t fade_mode);
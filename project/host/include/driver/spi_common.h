@@ -0,0 +1,29 @@
+#pragma once
+
+// host stand-in (see ../../idf/spi_master.cpp)
+
+#include <cstdint>
+
+#include "esp_err.h"
+
+typedef enum {
+    SPI_HOST	= 0,
+    HSPI_HOST	= 1,
+    VSPI_HOST	= 2,
+} spi_host_device_t;
+
+typedef struct {
+    int		mosi_io_num;
+    int		miso_io_num;
+    int		sclk_io_num;
+    int		quadwp_io_num;
+    int		quadhd_io_num;
+    int		max_transfer_sz;
+    uint32_t	flags;
+    int		intr_flags;
+} spi_bus_config_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host,
+    spi_bus_config_t const * config, int dmaChannel);
+
+esp_err_t spi_bus_free(spi_host_device_t host);
@@ -0,0 +1,63 @@
+#pragma once
+
+// host stand-in (see ../../idf/spi_master.cpp).
+// a transaction on a device is transmitted, after those queued before it,
+// by a thread for the device in the time it would take at its clock speed.
+// post_cb is called from that thread (as if from the ISR).
+
+#include <cstddef>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+
+#include "driver/spi_common.h"
+
+typedef struct spi_transaction_t spi_transaction_t;
+typedef void (*transaction_cb_t)(spi_transaction_t * transaction);
+
+struct spi_transaction_t {
+    uint32_t	flags;
+    uint16_t	cmd;
+    uint64_t	addr;
+    size_t	length;		///< bits
+    size_t	rxlength;	///< bits
+    void *	user;
+    union {
+	void const *	tx_buffer;
+	uint8_t		tx_data[4];
+    };
+    union {
+	void *		rx_buffer;
+	uint8_t		rx_data[4];
+    };
+};
+
+typedef struct {
+    uint8_t		command_bits;
+    uint8_t		address_bits;
+    uint8_t		dummy_bits;
+    uint8_t		mode;
+    uint16_t		duty_cycle_pos;
+    uint16_t		cs_ena_pretrans;
+    uint8_t		cs_ena_posttrans;
+    int			clock_speed_hz;
+    int			input_delay_ns;
+    int			spics_io_num;
+    uint32_t		flags;
+    int			queue_size;
+    transaction_cb_t	pre_cb;
+    transaction_cb_t	post_cb;
+} spi_device_interface_config_t;
+
+typedef struct spi_device_t * spi_device_handle_t;
+
+esp_err_t spi_bus_add_device(spi_host_device_t host,
+    spi_device_interface_config_t const * config, spi_device_handle_t * handle);
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle);
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle,
+    spi_transaction_t * transaction, TickType_t wait);
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle,
+    spi_transaction_t ** transaction, TickType_t wait);
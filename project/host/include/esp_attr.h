@@ -0,0 +1,5 @@
+#pragma once
+
+// host stand-in
+
+#define IRAM_ATTR
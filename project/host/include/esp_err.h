@@ -0,0 +1,29 @@
+#pragma once
+
+// host stand-in
+
+#include <cstdio>
+#include <cstdlib>
+
+typedef int esp_err_t;
+
+#define ESP_OK				0
+#define ESP_FAIL			-1
+#define ESP_ERR_NO_MEM			0x101
+#define ESP_ERR_INVALID_ARG		0x102
+#define ESP_ERR_INVALID_STATE		0x103
+#define ESP_ERR_INVALID_SIZE		0x104
+#define ESP_ERR_NOT_FOUND		0x105
+#define ESP_ERR_NOT_SUPPORTED		0x106
+#define ESP_ERR_TIMEOUT			0x107
+
+char const * esp_err_to_name(esp_err_t code);
+
+#define ESP_ERROR_CHECK(x) do { \
+    esp_err_t const e_ {x}; \
+    if (ESP_OK != e_) { \
+	std::fprintf(stderr, "%s:%d: ESP_ERROR_CHECK failed: %s (0x%x): %s\n", \
+	    __FILE__, __LINE__, esp_err_to_name(e_), e_, #x); \
+	std::abort(); \
+    } \
+} while (0)
@@ -0,0 +1,15 @@
+#pragma once
+
+// host stand-in: all memory is DMA capable
+
+#include <cstdlib>
+
+#define MALLOC_CAP_DMA 0
+
+inline void * heap_caps_malloc(std::size_t size, unsigned) {
+    return std::malloc(size);
+}
+
+inline void heap_caps_free(void * p) {
+    std::free(p);
+}
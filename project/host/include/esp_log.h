@@ -0,0 +1,37 @@
+#pragma once
+
+// host stand-in: logs to stderr.
+// only errors and warnings are logged
+// unless ARTLIGHT_LOG (in the environment) is I or D.
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+bool esp_log_enabled(esp_log_level_t level);
+
+void esp_log_write(esp_log_level_t level, char const * tag,
+    char const * format, ...) __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOG_LEVEL_(level, letter, tag, format, ...) do { \
+    if (esp_log_enabled(level)) { \
+	esp_log_write(level, tag, letter " (%s) " format "\n", tag, \
+	    ##__VA_ARGS__); \
+    } \
+} while (0)
+
+#define ESP_LOGE(tag, format, ...) \
+    ESP_LOG_LEVEL_(ESP_LOG_ERROR,	"E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) \
+    ESP_LOG_LEVEL_(ESP_LOG_WARN,	"W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) \
+    ESP_LOG_LEVEL_(ESP_LOG_INFO,	"I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) \
+    ESP_LOG_LEVEL_(ESP_LOG_DEBUG,	"D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) \
+    ESP_LOG_LEVEL_(ESP_LOG_VERBOSE,	"V", tag, format, ##__VA_ARGS__)
@@ -0,0 +1,50 @@
+#pragma once
+
+// host stand-in: data partitions are those added by the host
+// (see ../idf/Idf.h) and mapped where they are.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP	= 0x00,
+    ESP_PARTITION_TYPE_DATA	= 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_ANY	= 0xff,
+} esp_partition_subtype_t;
+
+typedef enum {
+    SPI_FLASH_MMAP_DATA,
+    SPI_FLASH_MMAP_INST,
+} spi_flash_mmap_memory_t;
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+    esp_partition_type_t	type;
+    esp_partition_subtype_t	subtype;
+    uint32_t			address;
+    uint32_t			size;
+    char			label[17];
+    bool			encrypted;
+    void const *		data;	///< host only
+} esp_partition_t;
+
+esp_partition_t const * esp_partition_find_first(
+    esp_partition_type_t	type,
+    esp_partition_subtype_t	subtype,
+    char const *		label);
+
+esp_err_t esp_partition_mmap(
+    esp_partition_t const *	partition,
+    size_t			offset,
+    size_t			size,
+    spi_flash_mmap_memory_t	memory,
+    void const **		out,
+    spi_flash_mmap_handle_t *	handle);
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle);
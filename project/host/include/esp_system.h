@@ -0,0 +1,14 @@
+#pragma once
+
+// host stand-in: shutdown handlers are run on esp_restart,
+// which then exits.
+
+#include "esp_err.h"
+
+typedef void (*shutdown_handler_t)();
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler);
+
+esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t handler);
+
+void esp_restart() __attribute__((noreturn));
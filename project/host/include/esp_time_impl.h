@@ -0,0 +1,7 @@
+#pragma once
+
+// host stand-in for the newlib private header (a C header)
+
+#include <cstdint>
+
+extern "C" uint64_t esp_time_impl_get_time_since_boot();
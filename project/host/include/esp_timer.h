@@ -0,0 +1,37 @@
+#pragma once
+
+// host stand-in (see ../idf/esp_timer.cpp).
+// time is microseconds since the process started (boot).
+// callbacks are run, in order, by the (host) esp_timer task.
+
+#include <cstdint>
+
+#include "esp_err.h"
+
+typedef struct esp_timer * esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void * arg);
+
+typedef enum {
+    ESP_TIMER_TASK,
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t		callback;
+    void *			arg;
+    esp_timer_dispatch_t	dispatch_method;
+    char const *		name;
+    bool			skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(esp_timer_create_args_t const * args,
+    esp_timer_handle_t * handle);
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout);
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+int64_t esp_timer_get_time();
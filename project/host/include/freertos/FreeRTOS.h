@@ -0,0 +1,37 @@
+#pragma once
+
+// host stand-in for the esp-idf port of FreeRTOS (see ../../idf/freertos.cpp).
+// a task is a std::thread.
+// priorities are kept but not enforced.
+// what esp-idf's FreeRTOS.h includes (assert, esp_timer and sdkconfig)
+// is included too.
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+typedef int		BaseType_t;
+typedef unsigned	UBaseType_t;
+typedef uint32_t	TickType_t;
+
+#define pdFALSE			0
+#define pdTRUE			1
+#define pdFAIL			0
+#define pdPASS			1
+
+#define configTICK_RATE_HZ	100
+#define portTICK_PERIOD_MS	(1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY		UINT32_MAX
+#define pdMS_TO_TICKS(ms)	((TickType_t) (ms) / portTICK_PERIOD_MS)
+
+#define tskNO_AFFINITY		0x7fffffff
+#define tskIDLE_PRIORITY	0
+
+// there are no interrupts on the host
+#define portYIELD_FROM_ISR()
+
+/// the core that the current task was pinned to (or 0)
+BaseType_t xPortGetCoreID();
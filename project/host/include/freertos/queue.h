@@ -0,0 +1,16 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct QueueDefinition * QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+
+void vQueueDelete(QueueHandle_t queue);
+
+BaseType_t xQueueSend(QueueHandle_t queue, void const * item, TickType_t wait);
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, void const * item,
+    BaseType_t * woken);
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void * item, TickType_t wait);
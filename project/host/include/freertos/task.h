@@ -0,0 +1,26 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct tskTaskControlBlock * TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(
+    TaskFunction_t	function,
+    char const *	name,
+    uint32_t		stackDepth,
+    void *		parameters,
+    UBaseType_t		priority,
+    TaskHandle_t *	createdTask,
+    BaseType_t		core);
+
+/// only a task may delete itself (nullptr), which it does as it returns
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+
+char * pcTaskGetTaskName(TaskHandle_t task);
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+// timer callbacks and pended functions are run, in order,
+// by the (host) timer daemon task.
+
+typedef struct tmrTimerControl * TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+typedef void (*PendedFunction_t)(void *, uint32_t);
+
+TimerHandle_t xTimerCreate(
+    char const *		name,
+    TickType_t			period,
+    UBaseType_t			autoReload,
+    void *			id,
+    TimerCallbackFunction_t	callback);
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait);
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t wait);
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period,
+    TickType_t wait);
+
+TickType_t xTimerGetPeriod(TimerHandle_t timer);
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t wait);
+
+void * pvTimerGetTimerID(TimerHandle_t timer);
+
+void vTimerSetTimerID(TimerHandle_t timer, void * id);
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t function,
+    void * parameter1, uint32_t parameter2, TickType_t wait);
+
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function,
+    void * parameter1, uint32_t parameter2, BaseType_t * woken);
@@ -0,0 +1,5 @@
+#pragma once
+
+// host stand-in for the newlib header
+
+#include <endian.h>
@@ -0,0 +1,46 @@
+#pragma once
+
+// host stand-in: namespaces of strings and blobs are kept in memory
+// (for the life of the program) and writes and commits are counted
+// (see ../idf/Idf.h).
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_BASE		0x1100
+#define ESP_ERR_NVS_NOT_INITIALIZED	(ESP_ERR_NVS_BASE + 0x01)
+#define ESP_ERR_NVS_NOT_FOUND		(ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_INVALID_HANDLE	(ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_INVALID_LENGTH	(ESP_ERR_NVS_BASE + 0x0c)
+
+typedef uint32_t nvs_handle_t;
+typedef nvs_handle_t nvs_handle;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE,
+} nvs_open_mode_t;
+typedef nvs_open_mode_t nvs_open_mode;
+
+esp_err_t nvs_open(char const * name, nvs_open_mode_t open_mode,
+    nvs_handle_t * out_handle);
+
+void nvs_close(nvs_handle_t handle);
+
+esp_err_t nvs_set_str(nvs_handle_t handle, char const * key,
+    char const * value);
+
+esp_err_t nvs_get_str(nvs_handle_t handle, char const * key,
+    char * out_value, size_t * length);
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, char const * key,
+    void const * value, size_t length);
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, char const * key,
+    void * out_value, size_t * length);
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, char const * key);
+
+esp_err_t nvs_commit(nvs_handle_t handle);
@@ -0,0 +1,13 @@
+#pragma once
+
+// host stand-in for the sdkconfig.h generated from ../../main/Kconfig.projbuild.
+// int (and string) configs have their defaults here.
+// bool configs are defined (or not) by ../CMakeLists.txt.
+
+#define CONFIG_OTA_URL			"https://artlightserver:4433/project.bin"
+#define CONFIG_TIME_SERVERS		"0.us.pool.ntp.org 1.us.pool.ntp.org 2.us.pool.ntp.org"
+#define CONFIG_TIME_ZONE		"PST+8PDT,M3.2.0/2,M11.1.0"
+#define CONFIG_ARTLIGHT_APA102_REFRESH	50
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+#define CONFIG_ARTLIGHT_CAPTURE_BYTES	32768
+#endif
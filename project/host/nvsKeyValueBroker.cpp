@@ -0,0 +1,146 @@
+// NVSKeyValueBroker write-behind on the NVS stand-in, which counts commits.
+// dragging a slider (publishing a value every few milliseconds)
+// must commit (about) once per latest, not once per value,
+// too many dirty values must be committed at once,
+// and dirty values must be committed on destruction and on esp_restart.
+// what is committed must be what is read back, from a new broker.
+// values stored in the older layout (an NVS string for each key)
+// must be read (and, with CONFIG_ARTLIGHT_NVS_BLOB, migrated).
+//
+//	./nvsKeyValueBroker [values]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "esp_system.h"
+#include "nvs.h"
+
+#include "Idf.h"
+#include "NVSKeyValueBroker.h"
+
+#include "check.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+char const * const name {"preferences"};
+
+/// the value of key read back from a new broker
+std::string readBack(char const * key) {
+    NVSKeyValueBroker keyValueBroker {name};
+    std::string value;
+    KeyValueBroker::Observer const observer {keyValueBroker, key, nullptr,
+	[&value](char const * value_){value = value_;}};
+    return value;
+}
+
+void sleepFor(unsigned milliseconds) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+unsigned commitsBefore;
+
+void checkRestart() {
+    // after NVSKeyValueBroker's shutdown handler
+    check(commitsBefore + 1 == Idf::nvsCommits());
+    check("8" == readBack("gamma"));
+    std::fflush(stdout);
+    std::_Exit(checkFailures());
+}
+
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 60u};
+
+    // a value stored in the older layout
+    {
+	nvs_handle nvs;
+	check(ESP_OK == nvs_open(name, NVS_READWRITE, &nvs));
+	check(ESP_OK == nvs_set_str(nvs, "old", "stored"));
+	check(ESP_OK == nvs_commit(nvs));
+	nvs_close(nvs);
+    }
+    check("stored" == readBack("old"));
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    {
+	// migrated (erased when the blob was committed)
+	nvs_handle nvs;
+	check(ESP_OK == nvs_open(name, NVS_READWRITE, &nvs));
+	size_t length;
+	check(ESP_ERR_NVS_NOT_FOUND
+	    == nvs_get_str(nvs, "old", nullptr, &length));
+	nvs_close(nvs);
+    }
+    check("stored" == readBack("old"));
+#endif
+
+    // drag a slider: a value every 10 milliseconds
+    unsigned constexpr quiet {100}, latest {300}, step {10};
+    unsigned commits {Idf::nvsCommits()};
+    Clock::duration dragging;
+    {
+	NVSKeyValueBroker keyValueBroker {name, quiet, latest};
+	auto const start {Clock::now()};
+	for (unsigned i {0}; i < count; ++i) {
+	    keyValueBroker.publish("level", std::to_string(i).c_str());
+	    sleepFor(step);
+	}
+	dragging = Clock::now() - start;
+	sleepFor(2 * quiet);
+	unsigned const dragCommits {Idf::nvsCommits() - commits};
+	unsigned const bound {static_cast<unsigned>(
+	    dragging / std::chrono::milliseconds(latest)) + 2};
+	check(0 < dragCommits);
+	check(dragCommits <= bound);
+	std::printf("%u values over %.0f milliseconds: %u commits"
+	    " (at most %u, %u without write-behind)\n",
+	    count, std::chrono::duration<double, std::milli>(dragging).count(),
+	    dragCommits, bound, count);
+	commits = Idf::nvsCommits();
+    }
+    check(commits == Idf::nvsCommits());	// nothing left dirty
+    check(std::to_string(count - 1) == readBack("level"));
+
+    // too many dirty values are committed at once (long before quiet)
+    commits = Idf::nvsCommits();
+    {
+	std::size_t constexpr dirtyMax {8};
+	NVSKeyValueBroker keyValueBroker {name, 10000, 10000, dirtyMax};
+	for (unsigned i {0}; i < dirtyMax; ++i) {
+	    std::string const key {"key" + std::to_string(i)};
+	    keyValueBroker.publish(key.c_str(), key.c_str());
+	}
+	auto const deadline {Clock::now() + std::chrono::seconds(5)};
+	while (commits == Idf::nvsCommits() && Clock::now() < deadline) {
+	    sleepFor(1);
+	}
+	check(commits + 1 == Idf::nvsCommits());
+	commits = Idf::nvsCommits();
+    }
+    check(commits == Idf::nvsCommits());
+    check("key7" == readBack("key7"));
+
+    // dirty values are committed on destruction
+    commits = Idf::nvsCommits();
+    {
+	NVSKeyValueBroker keyValueBroker {name, 10000, 10000};
+	keyValueBroker.publish("dim", "4032");
+	check(commits == Idf::nvsCommits());
+    }
+    check(commits + 1 == Idf::nvsCommits());
+    check("4032" == readBack("dim"));
+
+    // and on esp_restart (which does not return)
+    NVSKeyValueBroker keyValueBroker {name, 10000, 10000};
+    esp_register_shutdown_handler(checkRestart);
+    keyValueBroker.publish("gamma", "8");
+    commitsBefore = Idf::nvsCommits();
+    esp_restart();
+}
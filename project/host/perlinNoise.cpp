@@ -0,0 +1,73 @@
+// PerlinNoiseQ16 against PerlinNoise
+// and its batch evaluation against its per point evaluation
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "PerlinNoise.hpp"
+#include "PerlinNoiseQ16.h"
+
+#include "check.h"
+
+int main() {
+    // seeded the same, both have the same permutation
+    std::mt19937 rng, rngQ16;
+    PerlinNoise const noise {rng};
+    PerlinNoiseQ16 const noiseQ16 {rngQ16};
+
+    std::mt19937 points;
+    std::uniform_real_distribution<float> coordinate {-2.0f, 258.0f};
+    float max1 {0.0f}, max2 {0.0f}, max3 {0.0f}, max3octaves {0.0f};
+    for (unsigned i {0}; i < 100000; ++i) {
+	float const x {coordinate(points)};
+	float const y {coordinate(points)};
+	float const z {coordinate(points)};
+	max1 = std::max(max1, std::abs(noise.noise(x) - noiseQ16.noise(x)));
+	max2 = std::max(max2,
+	    std::abs(noise.noise(x, y) - noiseQ16.noise(x, y)));
+	max3 = std::max(max3,
+	    std::abs(noise.noise(x, y, z) - noiseQ16.noise(x, y, z)));
+	max3octaves = std::max(max3octaves, std::abs(
+	    noise.octaveNoise(x, y, z, 4) - noiseQ16.octaveNoise(x, y, z, 4)));
+    }
+    // as documented in PerlinNoiseQ16.h
+    check(max1 < 1e-4f);
+    check(max2 < 2e-4f);
+    check(max3 < 2.5e-4f);
+    check(max3octaves < 3e-4f);
+    std::printf("max error 1D %g 2D %g 3D %g 3D (4 octaves) %g\n",
+	max1, max2, max3, max3octaves);
+
+    // a batch of 3 noises (as R, G and B) at an odd number of points
+    // (more than a chunk) is the same as each point on its own.
+    PerlinNoiseQ16 const rgb[] {rngQ16, rngQ16, rngQ16};
+    PerlinNoiseQ16 const * const noises[] {&rgb[0], &rgb[1], &rgb[2]};
+    size_t constexpr count {101};
+    std::vector<float> xs, ys, zs;
+    for (size_t i {0}; i < count; ++i) {
+	xs.push_back(coordinate(points));
+	ys.push_back(coordinate(points));
+	zs.push_back(coordinate(points));
+    }
+    for (std::int32_t octaves: {1, 3}) {
+	std::vector<float> results(3 * count);
+	PerlinNoiseQ16::octaveNoise0_1(noises, 3, count,
+	    xs.data(), ys.data(), zs.data(), results.data(), octaves);
+	for (size_t i {0}; i < count; ++i) {
+	    for (size_t n {0}; n < 3; ++n) {
+		float const expected {
+		    rgb[n].octaveNoise0_1(xs[i], ys[i], zs[i], octaves)};
+		float const result {results[i * 3 + n]};
+		if (1 == octaves) {
+		    check(expected == result);
+		} else {
+		    // the batch sums octaves in float, not in Q16.16
+		    // (truncated by each shift)
+		    check(std::abs(expected - result) < octaves / 65536.0f);
+		}
+	    }
+	}
+    }
+    return checkFailures();
+}
@@ -0,0 +1,89 @@
+// perlinTime measures, on the host, the throughput of PerlinNoise (float)
+// and PerlinNoiseQ16 (Q16.16 fixed point) on 1D, 2D and 3D inputs
+// and of PerlinNoiseQ16's batch evaluation (as golden swirl uses it).
+// the target (whose float unit is slow) gains more from Q16 than the host.
+//
+//	./perlinTime [samples]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "PerlinNoise.hpp"
+#include "PerlinNoiseQ16.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::vector<float> xs, ys, zs;
+float volatile sink;	// so that nothing is optimized away
+
+// millions of samples per second of f over all points
+template <typename F>
+double throughput(F const & f) {
+    auto const start {Clock::now()};
+    float sum {0.0f};
+    for (size_t i {0}; i < xs.size(); ++i) sum += f(xs[i], ys[i], zs[i]);
+    sink = sum;
+    double const seconds
+	{std::chrono::duration<double>(Clock::now() - start).count()};
+    return seconds ? xs.size() / seconds / 1e6 : 0.0;
+}
+
+}
+
+int main(int argc, char ** argv) {
+    size_t const count {argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+	: 1000000ul};
+
+    std::mt19937 rng, rngQ16;
+    PerlinNoise const noise {rng};
+    PerlinNoiseQ16 const noiseQ16 {rngQ16};
+
+    std::mt19937 points;
+    std::uniform_real_distribution<float> coordinate {-2.0f, 258.0f};
+    for (size_t i {0}; i < count; ++i) {
+	xs.push_back(coordinate(points));
+	ys.push_back(coordinate(points));
+	zs.push_back(coordinate(points));
+    }
+
+    std::printf("millions of samples per second:\n");
+    std::printf("1D float %6.2f Q16 %6.2f\n",
+	throughput([&noise](float x, float, float){
+	    return noise.noise0_1(x);}),
+	throughput([&noiseQ16](float x, float, float){
+	    return noiseQ16.noise0_1(x);}));
+    std::printf("2D float %6.2f Q16 %6.2f\n",
+	throughput([&noise](float x, float y, float){
+	    return noise.noise0_1(x, y);}),
+	throughput([&noiseQ16](float x, float y, float){
+	    return noiseQ16.noise0_1(x, y);}));
+    std::printf("3D float %6.2f Q16 %6.2f\n",
+	throughput([&noise](float x, float y, float z){
+	    return noise.noise0_1(x, y, z);}),
+	throughput([&noiseQ16](float x, float y, float z){
+	    return noiseQ16.noise0_1(x, y, z);}));
+
+    // R, G and B noise at each point, one point at a time and in a batch
+    PerlinNoise const rgb[] {rng, rng, rng};
+    PerlinNoiseQ16 const rgbQ16[] {rngQ16, rngQ16, rngQ16};
+    PerlinNoiseQ16 const * const noises[]
+	{&rgbQ16[0], &rgbQ16[1], &rgbQ16[2]};
+    double const rgbFloat {3 * throughput([&rgb](float x, float y, float z){
+	return rgb[0].noise0_1(x, y, z) + rgb[1].noise0_1(x, y, z)
+	    + rgb[2].noise0_1(x, y, z);})};
+    std::vector<float> results(3 * count);
+    auto const start {Clock::now()};
+    PerlinNoiseQ16::octaveNoise0_1(noises, 3, count,
+	xs.data(), ys.data(), zs.data(), results.data());
+    double const seconds
+	{std::chrono::duration<double>(Clock::now() - start).count()};
+    sink = results[count / 2];
+    std::printf("3D RGB float %6.2f Q16 batch %6.2f\n",
+	rgbFloat, seconds ? 3 * count / seconds / 1e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,239 @@
+// pixelStream streams DDP frames over loopback UDP to a PixelStream
+// (on its own io_context thread, as GoldenArtTask's transmit task is)
+// and checks that each is written and pushed whole, that gaps,
+// late and malformed packets are counted (in its FrameStats)
+// and measures, from the first packet sent to the push,
+// end-to-end latency (one frame at a time)
+// and sustained frames per second (with a few frames in flight).
+// a frame of 600 pixels takes two packets (the second pushes).
+//
+//	./pixelStream [frames]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "asio.hpp"
+
+#include "FrameStats.h"
+#include "KeyValueBroker.h"
+#include "PixelStream.h"
+
+#include "check.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+size_t constexpr pixelCount	{600};
+size_t constexpr pixelSize	{3};
+size_t constexpr packetPixels	{pixelCount / 2};
+size_t constexpr headerSize	{10};
+
+// byte i of frame f. the first 4 bytes are f (big endian)
+uint8_t byteOf(uint32_t f, size_t i) {
+    return i < 4 ? f >> (8 * (3 - i)) : (f * 7 + i) & 0xff;
+}
+
+/// A Sender sends DDP packets to a port on loopback.
+class Sender {
+private:
+    asio::io_context		io;
+    asio::ip::udp::socket	socket;
+    asio::ip::udp::endpoint	endpoint;
+    unsigned			sequence;	///< last, cycles through 1-15
+    uint8_t			packet[headerSize + packetPixels * pixelSize];
+
+public:
+    Sender(unsigned short port)
+    :
+	io	(),
+	socket	(io, asio::ip::udp::v4()),
+	endpoint(asio::ip::address_v4::loopback(), port),
+	sequence(0),
+	packet	{}
+    {}
+
+    /// send length bytes of packet with the header given
+    void send(uint8_t flags, unsigned sequence_, uint8_t type,
+	size_t offset, size_t length)
+    {
+	packet[0] = flags;
+	packet[1] = sequence_;
+	packet[2] = type;
+	packet[3] = 0x01;
+	for (size_t i {0}; i < 4; ++i) packet[4 + i] = offset >> (8 * (3 - i));
+	size_t const dataSize {length - headerSize};
+	packet[8] = dataSize >> 8;
+	packet[9] = dataSize;
+	socket.send_to(asio::buffer(packet, length), endpoint);
+    }
+
+    unsigned nextSequence() {
+	return sequence = sequence % 15 + 1;
+    }
+
+    /// send frame f, the second packet with the push flag
+    void sendFrame(uint32_t f) {
+	for (size_t half {0}; half < 2; ++half) {
+	    size_t const offset {half * packetPixels * pixelSize};
+	    for (size_t i {0}; i < packetPixels * pixelSize; ++i) {
+		packet[headerSize + i] = byteOf(f, offset + i);
+	    }
+	    send(half ? 0x41 : 0x40, nextSequence(), 0x0b, offset,
+		headerSize + packetPixels * pixelSize);
+	}
+    }
+};
+
+/// the value of counter in frameStats.serialize()
+unsigned counted(FrameStats const & frameStats, char const * counter) {
+    std::string const json {frameStats.serialize()};
+    std::string const key {std::string("\"") + counter + "\":"};
+    size_t const at {json.find(key)};
+    return std::string::npos == at ? 0
+	: std::strtoul(json.c_str() + at + key.size(), nullptr, 10);
+}
+
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 1000u};
+
+    KeyValueBroker keyValueBroker {"keyValueBroker"};
+    FrameStats frameStats {keyValueBroker};
+    asio::io_context io;
+    asio::io_context::work work {io};
+
+    // what is written and pushed (latched), on io
+    std::vector<uint8_t> frame(pixelCount * pixelSize), latched(frame.size());
+    std::unique_ptr<std::atomic<Clock::rep>[]> sent
+	{new std::atomic<Clock::rep>[count]};
+    std::vector<Clock::duration> latencies;
+    latencies.reserve(count);
+    std::mutex mutex;
+    std::condition_variable condition;
+    unsigned pushes {0};	// under mutex
+    unsigned bad {0};		// on io
+    PixelStream pixelStream {"pixelStream", io, keyValueBroker,
+	"streamPort", "0",
+	[&frame](size_t offset, uint8_t const * rgb, size_t count_) {
+	    if (frame.size() < (offset + count_) * pixelSize) return;
+	    std::memcpy(frame.data() + offset * pixelSize, rgb,
+		count_ * pixelSize);
+	},
+	[&](){
+	    auto const now {Clock::now()};
+	    latched = frame;
+	    uint32_t f {0};
+	    for (size_t i {0}; i < 4; ++i) f = f << 8 | latched[i];
+	    bool good {true};
+	    for (size_t i {0}; i < latched.size(); ++i) {
+		good = good && byteOf(f, i) == latched[i];
+	    }
+	    if (!good) ++bad;
+	    if (good && f < count) {
+		latencies.push_back(now - Clock::time_point(
+		    Clock::duration(sent[f].load())));
+	    }
+	    std::lock_guard<std::mutex> lock {mutex};
+	    ++pushes;
+	    condition.notify_all();
+	},
+	frameStats};
+    std::thread ioThread {[&io](){io.run();}};
+
+    // wait (up to a second) for n pushes
+    auto const waitFor = [&](unsigned n) {
+	std::unique_lock<std::mutex> lock {mutex};
+	return condition.wait_for(lock, std::chrono::seconds(1),
+	    [&](){return n <= pushes;});
+    };
+
+    // an unprivileged port, outside of the ephemeral range,
+    // that concurrent runs are unlikely to share
+    unsigned short const port = 0xc000 - 1 - getpid() % 0x1000;
+    keyValueBroker.publish("streamPort", std::to_string(port).c_str());
+    io.post([&pixelStream](){pixelStream.start();});
+    {
+	// so that the socket is bound before anything is sent
+	std::promise<void> started;
+	io.post([&started](){started.set_value();});
+	started.get_future().wait();
+    }
+    Sender sender {port};
+
+    // malformed (version 2), late (a repeated sequence number) and gap
+    // (2 sequence numbers skipped) are counted. those after a gap are used.
+    sender.send(0x81, sender.nextSequence(), 0x0b, 0, headerSize + 3);
+    unsigned const late {sender.nextSequence()};
+    sender.send(0x40, late, 0x0b, 0, headerSize + 3);
+    sender.send(0x40, late, 0x0b, 0, headerSize + 3);
+    sender.nextSequence();
+    sender.nextSequence();
+    sender.sendFrame(count);	// not timed
+    check(waitFor(1));
+    check(1 == counted(frameStats, "streamErrors"));
+    check(1 == counted(frameStats, "streamLates"));
+    check(2 == counted(frameStats, "streamGaps"));
+
+    // latency: one frame at a time
+    unsigned const half {count / 2};
+    for (uint32_t f {0}; f < half; ++f) {
+	sent[f] = Clock::now().time_since_epoch().count();
+	sender.sendFrame(f);
+	if (!waitFor(2 + f)) break;
+    }
+    std::vector<Clock::duration> oneAtATime {latencies};
+
+    // throughput: up to window frames in flight
+    // (after the first, f + 1 have been pushed when f is done)
+    unsigned constexpr window {4};
+    auto const start {Clock::now()};
+    for (uint32_t f {half}; f < count; ++f) {
+	if (!waitFor(f + 2 > window ? f + 2 - window : 0)) break;
+	sent[f] = Clock::now().time_since_epoch().count();
+	sender.sendFrame(f);
+    }
+    check(waitFor(1 + count));
+    Clock::duration const streaming {Clock::now() - start};
+
+    io.post([&pixelStream, &io](){pixelStream.stop(); io.stop();});
+    ioThread.join();
+
+    check(0 == bad);
+    check(count == latencies.size());
+    check(2 == counted(frameStats, "streamGaps"));	// none dropped
+
+    auto const microseconds = [](Clock::duration duration) {
+	return std::chrono::duration<double, std::micro>(duration).count();
+    };
+    auto const percentile = [&](std::vector<Clock::duration> values,
+	unsigned percent)
+    {
+	if (values.empty()) return 0.0;
+	std::sort(values.begin(), values.end());
+	return microseconds(values[(values.size() - 1) * percent / 100]);
+    };
+    std::printf("frames %u latency microseconds p50 %.1f p99 %.1f,"
+	" streaming %.0f frames per second (%u in flight)\n",
+	count, percentile(oneAtATime, 50), percentile(oneAtATime, 99),
+	streaming.count() ? (count - half) / (microseconds(streaming) / 1e6)
+	    : 0.0,
+	window);
+    return checkFailures();
+}
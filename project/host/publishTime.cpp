@@ -0,0 +1,192 @@
+// publishTime measures, on the host, the time and heap allocations
+// that publishing the value of a known key takes,
+// among many keys and with some (synchronous) observers of it,
+// before (std::map lookups by std::string and a std::set of observers,
+// as KeyValueBroker had) and after (interned Ids, as it has now).
+// keys are short (as most are, within std::string's small buffer)
+// or long (allocated, when a std::string is made of them).
+// it also measures publishing to an asynchronous (Mailbox) observer
+// whose io_context is not run until the end, so that its letter coalesces.
+// after, a synchronous publish must not allocate.
+//
+//	./publishTime [publishes]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "KeyValueBroker.h"
+
+#include "check.h"
+
+static std::atomic<unsigned long> allocations {0};
+
+void * operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void * const pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * pointer) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Observe = std::function<void(char const *)>;
+
+unsigned constexpr keyCount {64};
+
+/// before: what KeyValueBroker::publish did
+class MapBroker {
+private:
+    using Observers = std::set<Observe const *>;
+    std::recursive_mutex		mutex;
+    std::map<std::string, Observers *>	observersFor;
+    std::map<std::string, std::string>	valueFor;
+
+    bool set(char const * key, char const * value) {
+	auto valueIt = valueFor.find(key);
+	if (valueIt != valueFor.end() && 0 == valueIt->second.compare(value)) {
+	    return false;
+	}
+	valueFor[key] = value;
+	return true;
+    }
+
+public:
+    void subscribe(char const * key, Observe const & observe) {
+	auto & observers = observersFor[key];
+	if (!observers) observers = new Observers;
+	observers->insert(&observe);
+    }
+
+    void publish(char const * key, char const * value) {
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	if (set(key, value)) {
+	    auto observers = observersFor.find(key);
+	    if (observers != observersFor.end()) {
+		for (auto observer: *observers->second) {
+		    (*observer)(value);
+		}
+	    }
+	}
+    }
+
+    ~MapBroker() {
+	for (auto & observers: observersFor) delete observers.second;
+    }
+};
+
+std::string keyOf(unsigned k, char const * prefix = "key") {
+    char key[64];
+    std::snprintf(key, sizeof key, "%s%02u", prefix, k);
+    return key;
+}
+
+struct Result {
+    double	nanoseconds;	///< per publish
+    double	allocations;	///< per publish
+};
+
+/// publish count different values (of the same length) of key
+template <typename Publish>
+Result measure(unsigned count, char const * key, Publish const & publish) {
+    std::vector<std::string> values;
+    for (unsigned v {0}; v < 16; ++v) values.push_back("value" + keyOf(v));
+    publish(key, values.back().c_str());
+    unsigned long const allocated {allocations};
+    auto const start {Clock::now()};
+    for (unsigned i {0}; i < count; ++i) publish(key, values[i % 16].c_str());
+    Clock::duration const duration {Clock::now() - start};
+    return {count ? std::chrono::duration<double, std::nano>(duration).count()
+	    / count : 0.0,
+	count ? static_cast<double>(allocations - allocated) / count : 0.0};
+}
+
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 1000000u};
+
+    unsigned observed {0};
+    Observe const observe {[&observed](char const *){++observed;}};
+
+    std::printf("%u keys, nanoseconds (allocations) per publish:\n", keyCount);
+    for (char const * prefix: {"key", "aLongerPreferenceKey"})
+    for (unsigned observerCount: {0u, 1u, 4u}) {
+	auto const keyOf = [prefix](unsigned k) {return ::keyOf(k, prefix);};
+	std::string const key {keyOf(keyCount / 2)};
+	MapBroker mapBroker;
+	for (unsigned k {0}; k < keyCount; ++k) {
+	    mapBroker.publish(keyOf(k).c_str(), "0");
+	}
+	std::vector<Observe> observes(observerCount, observe);
+	for (auto const & o: observes) mapBroker.subscribe(key.c_str(), o);
+	Result const before {measure(count, key.c_str(),
+	    [&mapBroker](char const * key_, char const * value) {
+		mapBroker.publish(key_, value);
+	    })};
+
+	KeyValueBroker keyValueBroker {"keyValueBroker"};
+	for (unsigned k {0}; k < keyCount; ++k) {
+	    keyValueBroker.publish(keyOf(k).c_str(), "0");
+	}
+	std::vector<std::unique_ptr<KeyValueBroker::Observer>> observers;
+	for (unsigned o {0}; o < observerCount; ++o) {
+	    observers.emplace_back(new KeyValueBroker::Observer {
+		keyValueBroker, key.c_str(), "0", Observe {observe}});
+	}
+	observed = 0;
+	Result const after {measure(count, key.c_str(),
+	    [&keyValueBroker](char const * key_, char const * value) {
+		keyValueBroker.publish(key_, value);
+	    })};
+	check((count + 1) * observerCount == observed);
+	check(0.0 == after.allocations);
+
+	std::printf("%-5s keys, %u observers:"
+	    " before %6.1f (%.1f) after %6.1f (%.1f)\n",
+	    key.size() < 16 ? "short" : "long", observerCount,
+	    before.nanoseconds, before.allocations,
+	    after.nanoseconds, after.allocations);
+    }
+
+    // an asynchronous observer, delivered to at the end
+    {
+	std::string const key {keyOf(keyCount / 2)};
+	asio::io_context io;
+	KeyValueBroker keyValueBroker {"keyValueBroker"};
+	for (unsigned k {0}; k < keyCount; ++k) {
+	    keyValueBroker.publish(keyOf(k).c_str(), "0");
+	}
+	std::string last;
+	KeyValueBroker::Observer const observer {keyValueBroker, key.c_str(),
+	    "0", io, [&last](char const * value){last = value;}};
+	io.run();
+	io.restart();
+	Result const async {measure(count, key.c_str(),
+	    [&keyValueBroker](char const * key_, char const * value) {
+		keyValueBroker.publish(key_, value);
+	    })};
+	io.run();
+	check(("value" + keyOf((count + 15) % 16)) == last);
+	std::printf("1 asynchronous observer: %6.1f (%.1f), %u coalesced\n",
+	    async.nanoseconds, async.allocations, keyValueBroker.coalesced());
+    }
+    return checkFailures();
+}
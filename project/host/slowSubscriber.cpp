@@ -0,0 +1,229 @@
+// slowSubscriber stresses KeyValueBroker with publishers (threads that
+// publish as fast as they can) and slow asynchronous subscribers
+// (each on its own io_context thread, taking a while for each delivery)
+// and measures publish latency: constant with asynchronous subscribers,
+// the subscriber's delay with a synchronous one.
+// while publishing, a subscriber republishes what it observes
+// and another subscribes and unsubscribes, over and over.
+// every subscriber must observe the last value published for each key
+// (nothing is dropped), the values of a key in order
+// and all must be done in time (nothing deadlocks).
+//
+//	./slowSubscriber [publishes]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "KeyValueBroker.h"
+
+#include "check.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+unsigned constexpr publisherCount	{4};
+unsigned constexpr keysPerPublisher	{4};
+unsigned constexpr keyCount		{publisherCount * keysPerPublisher};
+auto constexpr slow			{std::chrono::milliseconds(1)};
+
+std::string keyOf(unsigned k) {
+    return "key" + std::to_string(k);
+}
+
+/// A Subscriber observes all keys (and all, generally) from its own thread,
+/// slowly, and keeps the last value observed of each.
+class Subscriber {
+public:
+    asio::io_context					io;
+private:
+    asio::io_context::work				work;
+    std::vector<std::unique_ptr<KeyValueBroker::Observer>>	observers;
+    std::unique_ptr<KeyValueBroker::GeneralObserver>	generalObserver;
+    std::thread						thread;
+
+public:
+    std::vector<long>	last;		///< by key, from observers
+    std::vector<long>	lastGeneral;	///< by key, from generalObserver
+    unsigned		outOfOrder;
+
+    Subscriber(KeyValueBroker & keyValueBroker,
+	std::function<void(unsigned, long)> const & also = nullptr)
+    :
+	io		(),
+	work		(io),
+	observers	(),
+	generalObserver	(),
+	thread		(),
+	last		(keyCount, -1),
+	lastGeneral	(keyCount, -1),
+	outOfOrder	(0)
+    {
+	auto const observe = [this](std::vector<long> & last_,
+	    unsigned k, char const * value_)
+	{
+	    long const value {std::strtol(value_, nullptr, 10)};
+	    if (value < last_[k]) ++outOfOrder;
+	    last_[k] = value;
+	};
+	for (unsigned k {0}; k < keyCount; ++k) {
+	    observers.emplace_back(new KeyValueBroker::Observer {
+		keyValueBroker, keyOf(k).c_str(), "-1", io,
+		[this, k, observe, also](char const * value) {
+		    std::this_thread::sleep_for(slow);
+		    observe(last, k, value);
+		    if (also) also(k, last[k]);
+		}});
+	}
+	generalObserver.reset(new KeyValueBroker::GeneralObserver {
+	    keyValueBroker, io,
+	    [this, observe](char const * key, char const * value, bool) {
+		std::this_thread::sleep_for(slow);
+		if (0 != std::string(key).compare(0, 3, "key")) return;
+		observe(lastGeneral, std::strtoul(key + 3, nullptr, 10), value);
+	    }});
+	thread = std::thread([this](){io.run();});
+    }
+
+    /// call f on io and return what it does
+    template <typename F>
+    auto onIo(F const & f) -> decltype(f()) {
+	std::promise<decltype(f())> result;
+	io.post([&result, &f](){result.set_value(f());});
+	return result.get_future().get();
+    }
+
+    ~Subscriber() {
+	// observers are destroyed on io
+	onIo([this](){
+	    observers.clear();
+	    generalObserver.reset();
+	    return true;
+	});
+	io.stop();
+	thread.join();
+    }
+};
+
+double microseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+double percentile(std::vector<Clock::duration> & values, unsigned percent) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return microseconds(values[(values.size() - 1) * percent / 100]);
+}
+
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 2000u};
+
+    KeyValueBroker keyValueBroker {"keyValueBroker"};
+    std::vector<Clock::duration> latencies[publisherCount];
+    {
+	Subscriber subscriber {keyValueBroker};
+	// republishes (from its io thread) what it observes
+	Subscriber republisher {keyValueBroker,
+	    [&keyValueBroker](unsigned k, long value) {
+		keyValueBroker.publish(("echo" + keyOf(k)).c_str(),
+		    std::to_string(value).c_str());
+	    }};
+	// subscribes and unsubscribes (from its io thread)
+	Subscriber churner {keyValueBroker};
+	std::atomic<bool> publishing {true};
+	std::thread churn {[&](){
+	    while (publishing) {
+		churner.onIo([&keyValueBroker, &churner](){
+		    KeyValueBroker::Observer const observer {keyValueBroker,
+			keyOf(0).c_str(), nullptr, churner.io,
+			[](char const *){std::this_thread::sleep_for(slow);}};
+		    return true;
+		});
+	    }
+	}};
+
+	// each publisher publishes values 0 to count - 1 of its own keys
+	std::vector<std::thread> publishers;
+	for (unsigned p {0}; p < publisherCount; ++p) {
+	    latencies[p].reserve(count);
+	    publishers.emplace_back([&keyValueBroker, &latencies, count, p](){
+		for (unsigned i {0}; i < count; ++i) {
+		    std::string const key
+			{keyOf(p * keysPerPublisher + i % keysPerPublisher)};
+		    std::string const value {std::to_string(i)};
+		    auto const start {Clock::now()};
+		    keyValueBroker.publish(key.c_str(), value.c_str());
+		    latencies[p].push_back(Clock::now() - start);
+		}
+	    });
+	}
+	for (auto & publisher: publishers) publisher.join();
+	publishing = false;
+	churn.join();
+
+	// the last value of each key, as it was published
+	std::vector<long> published(keyCount, -1);
+	unsigned const first
+	    {count > keysPerPublisher ? count - keysPerPublisher : 0};
+	for (unsigned i {first}; i < count; ++i) {
+	    for (unsigned p {0}; p < publisherCount; ++p) {
+		published[p * keysPerPublisher + i % keysPerPublisher] = i;
+	    }
+	}
+	auto const deadline {Clock::now() + std::chrono::seconds(10)};
+	for (Subscriber * s: {&subscriber, &republisher, &churner}) {
+	    bool done {false};
+	    while (!done && Clock::now() < deadline) {
+		done = s->onIo([s, &published](){
+		    return published == s->last && published == s->lastGeneral;
+		});
+		if (!done) std::this_thread::sleep_for(slow);
+	    }
+	    check(done);
+	    check(0 == s->onIo([s](){return s->outOfOrder;}));
+	}
+    }
+
+    std::vector<Clock::duration> all;
+    for (auto const & l: latencies) all.insert(all.end(), l.begin(), l.end());
+    double const p50 {percentile(all, 50)}, p99 {percentile(all, 99)};
+    double const max {microseconds(all.back())};
+
+    // with a (slow) synchronous observer, a publish takes as long as it does
+    std::vector<Clock::duration> synchronous;
+    {
+	KeyValueBroker::Observer const observer {keyValueBroker,
+	    keyOf(0).c_str(), nullptr,
+	    [](char const *){std::this_thread::sleep_for(slow);}};
+	for (unsigned i {0}; i < 100; ++i) {
+	    auto const start {Clock::now()};
+	    keyValueBroker.publish(keyOf(0).c_str(),
+		std::to_string(count + i).c_str());
+	    synchronous.push_back(Clock::now() - start);
+	}
+    }
+    double const synchronousP50 {percentile(synchronous, 50)};
+    check(p50 * 10 < synchronousP50);
+
+    std::printf("%u publishers of %u values, 3 subscribers of %.0f"
+	" microseconds each: publish microseconds p50 %.1f p99 %.1f max %.1f,"
+	" synchronous p50 %.1f, %u coalesced\n",
+	publisherCount, count, microseconds(slow), p50, p99, max,
+	synchronousP50, keyValueBroker.coalesced());
+    return checkFailures();
+}
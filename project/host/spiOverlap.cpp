@@ -0,0 +1,117 @@
+// SPI::AsyncTransaction lets rendering the next frame overlap transmitting
+// the last (where an SPI::Transaction blocks until it is done).
+// on the SPI master stand-in, a transaction takes the time that it would
+// at the device's clock speed, so frames that take a little longer
+// to render than to transmit should take about half as long with overlap.
+// a transaction completes (through io) unless the next is queued first
+// (and reaps it) but the last always completes.
+// the best of a few tries of each is reported.
+//
+//	./spiOverlap [frames]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "SPI.h"
+
+#include "check.h"
+
+using Clock = std::chrono::steady_clock;
+
+static int constexpr clockSpeed {4000000};
+static size_t constexpr frameBytes {2000};	// 4 ms at clockSpeed
+static Clock::duration constexpr renderTime {std::chrono::milliseconds(6)};
+static unsigned constexpr tries {3};
+
+// keep the CPU busy (as rendering would) for renderTime
+static void render(std::vector<uint8_t> & frame) {
+    Clock::time_point const end {Clock::now() + renderTime};
+    uint8_t value {0};
+    while (Clock::now() < end) {
+	for (auto & byte: frame) byte = value++;
+    }
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 20u};
+
+    asio::io_context io;
+    asio::io_context::work work {io};	// so that it never stops
+    SPI::Bus const bus {VSPI_HOST, SPI::Bus::Config(), 1};
+    SPI::Device const device {&bus, SPI::Device::Config()
+	.mode_(3)
+	.clock_speed_hz_(clockSpeed)
+	.spics_io_num_(-1)
+	.queue_size_(1)
+	.post_cb_(SPI::AsyncTransaction::postCallback)};
+
+    // double buffered, as GoldenArtTask's frames are
+    std::vector<uint8_t> frames[2] {
+	std::vector<uint8_t>(frameBytes), std::vector<uint8_t>(frameBytes)};
+    auto const configOf = [](std::vector<uint8_t> const & frame) {
+	return SPI::Transaction::Config()
+	    .tx_buffer_(frame.data())
+	    .length_(8 * frame.size());
+    };
+
+    // blocking: render, then transmit (and wait)
+    auto const blockingTime = [&]() {
+	Clock::time_point const start {Clock::now()};
+	for (unsigned f {0}; f < count; ++f) {
+	    render(frames[0]);
+	    SPI::Transaction::Config config {configOf(frames[0])};
+	    SPI::Transaction transaction {device, config};
+	}
+	return Clock::now() - start;
+    };
+
+    // overlapped: render the back frame while the front is transmitted
+    unsigned completed {0};
+    auto const overlappedTime = [&]() {
+	completed = 0;
+	SPI::AsyncTransaction transaction {device, io};
+	Clock::time_point const start {Clock::now()};
+	for (unsigned f {0}; f < count; ++f) {
+	    std::vector<uint8_t> & back {frames[f & 1]};
+	    render(back);
+	    io.poll();
+	    transaction.queue(configOf(back), [&completed](){++completed;});
+	}
+	Clock::time_point const deadline
+	    {Clock::now() + std::chrono::seconds(5)};
+	while (transaction.isPending() && Clock::now() < deadline) {
+	    io.run_one_for(std::chrono::milliseconds(10));
+	}
+	Clock::duration const overlapped_ {Clock::now() - start};
+	check(!transaction.isPending());
+	check(0 < completed);
+	return overlapped_;
+    };
+
+    // the best of a few tries of each (so that a host hiccup does not count)
+    Clock::duration blocking {Clock::duration::max()};
+    Clock::duration overlapped {Clock::duration::max()};
+    for (unsigned t {0}; t < tries; ++t) {
+	blocking = std::min(blocking, blockingTime());
+	overlapped = std::min(overlapped, overlappedTime());
+    }
+    check(blocking * 3 > overlapped * 4);
+
+    auto const perFrame = [count](Clock::duration duration) {
+	return count ? std::chrono::duration<double, std::milli>(duration)
+	    .count() / count : 0.0;
+    };
+    std::printf("frames %u milliseconds per frame: blocking %.2f"
+	" overlapped %.2f (render %.2f, transmit %.2f) completed %u\n",
+	count, perFrame(blocking), perFrame(overlapped),
+	std::chrono::duration<double, std::milli>(renderTime).count(),
+	8e3 * frameBytes / clockSpeed, completed);
+    return checkFailures();
+}
@@ -53,43 +53,78 @@ template LED<unsigned>::operator uint32_t() const;
 // values out will effectively be shifted right by 4
 // by scaling as much as possible first
 // before shifting (which is where precision is lost).
-template <> LED<int16_t>::operator uint32_t () const {
+//
+// the parts share the shift of the largest one.
+// as the shift is determined only by the highest set bit,
+// it can be computed once from the bitwise or of all parts.
+// there are no data dependent branches here
+// (the conditional expressions compile to conditional moves)
+// so that the loops that use this may be pipelined.
+// ins are parts in encoding order (most significant byte first).
+static inline uint32_t encode12(int16_t const (&ins)[3]) {
     constexpr int16_t	inMax 		{0x0fff};
     constexpr uint8_t	outMax		{0xff};
     constexpr unsigned	inMaxClz	{__builtin_clz(inMax)};
     constexpr unsigned	outMaxClz	{__builtin_clz(outMax)};
     constexpr unsigned	shiftTotal	{outMaxClz - inMaxClz};
-    int16_t ins[3] {
+    uint32_t clipped[3];
+    uint32_t any {1};	// avoid undefined __builtin_clz(0)
+    for (auto i = 0; i < 3; ++i) {
+	int16_t const in {ins[i]};
+	clipped[i] = 0 > in ? 0 : inMax < in ? inMax : in;
+	any |= clipped[i];
+    }
+    unsigned const clz {static_cast<unsigned>(__builtin_clz(any))};
+    unsigned const shift {outMaxClz < clz ? 0 : outMaxClz - clz};
+    uint32_t outs {0};
+    for (auto & in: clipped) {
+	uint32_t const out {in >> shift};
+	// make sure something goes out if we got something in
+	outs = (outs | out | (!out & !!in)) << 8;
+    }
+    return outs | 0b11100000 | (0b11111 >> (shiftTotal - shift));
+}
+
+template <> LED<int16_t>::operator uint32_t () const {
+    return encode12({
 	*(&part.control + 3),
 	*(&part.control + 2),
 	*(&part.control + 1),
-    };
-    unsigned shiftEach {0};
-    for (auto & in: ins) { if (in) {
-	if (in < 0) in = 0;		// clip blacks
-	else {
-	    unsigned shift {0};
-	    if (in > inMax) {
-		in = inMax;		// clip whites
-		shift = shiftTotal;
-	    } else {
-		shift = outMaxClz - std::min(
-		    outMaxClz, static_cast<unsigned>(__builtin_clz(in)));
-	    }
-	    if (shiftEach < shift) shiftEach = shift;
-	}
-    }}
-    uint32_t outs {0};
-    for (auto & in: ins) {
-	if (in) {
-	    // we got something in.
-	    uint32_t out {static_cast<uint32_t>(in >> shiftEach)};
-	    if (!out) out = 1;	// make sure something goes out
-	    outs |= out;
-	}
-	outs <<= 8;
+    });
+}
+
+void encode(uint32_t * encodings, LED<int16_t> const * leds, std::size_t size,
+	GammaEncode12 const & g, uint16_t const * layout) {
+    encode(encodings, leds, size, [&g](LED<int16_t> const & led) {
+	int16_t const * const part {&led.part.control};
+	return encode12({g(part[3]), g(part[2]), g(part[1])});
+    }, layout);
+}
+
+uint32_t digest(uint32_t const * encodings, std::size_t size) {
+    uint32_t result {2166136261u};
+    for (std::size_t i {0}; i < size; ++i) {
+	result = (result ^ encodings[i]) * 16777619u;
+    }
+    return result;
+}
+
+Unchanged::Unchanged(unsigned refresh_) :
+    refresh	{refresh_},
+    lastDigest	{0},
+    unsent	{refresh_},	// never skip the first
+    skipped_	{0}
+{}
+
+bool Unchanged::operator()(uint32_t const * encodings, std::size_t size) {
+    uint32_t const digest_ {digest(encodings, size)};
+    if (digest_ == lastDigest && ++unsent < refresh) {
+	++skipped_;
+	return true;
     }
-    return outs | 0b11100000 | (0b11111 >> (shiftTotal - shiftEach));
+    lastDigest = digest_;
+    unsent = 0;
+    return false;
 }
 
 }
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <limits>
+#include <new>
 #include <sstream>
 #include <string>
 
+#include "esp_heap_caps.h"
+
 #include "GammaEncode.h"
 
 namespace APA102 {
@@ -118,6 +122,9 @@ public:
     template <typename t> LED(GammaEncode const & g, LED<t> const & that) :
 	LED(g(that.part.red), g(that.part.green), g(that.part.blue)) {}
 
+    template <typename t> LED(GammaEncode12 const & g, LED<t> const & that) :
+	LED(g(that.part.red), g(that.part.green), g(that.part.blue)) {}
+
     LED(uint32_t encoding);
 
     LED(char const * c) : LED(
@@ -267,8 +274,38 @@ LED<int16_t> LED<int16_t>::operator * (F multiplier) const {
 	static_cast<int16_t>(part.blue	* multiplier)};
 }
 
+/// encode size leds, with gamma correction, into encodings in one pass.
+/// if layout is not null, leds[i] is encoded to encodings[layout[i]]
+/// (wiring order); otherwise, the orders are the same.
+void encode(uint32_t * encodings, LED<int16_t> const * leds, std::size_t size,
+    GammaEncode12 const & gammaEncode, uint16_t const * layout = nullptr);
+
+/// encode size leds, by the encode function, into encodings in one pass.
+/// layout is interpreted as above.
+template <typename T, typename Encode>
+void encode(uint32_t * encodings, LED<T> const * leds, std::size_t size,
+	Encode encode, uint16_t const * layout = nullptr) {
+    if (layout) {
+	for (std::size_t i {0}; i < size; ++i) {
+	    encodings[layout[i]] = encode(leds[i]);
+	}
+    } else {
+	for (std::size_t i {0}; i < size; ++i) {
+	    encodings[i] = encode(leds[i]);
+	}
+    }
+}
+
 std::size_t constexpr messageBits(std::size_t size) {return 32 + size * 65 / 2 + 32;}
 
+/// bytes to pad a size LED Message with (beyond its start, encodings and
+/// update words) to cover messageBits(size).
+/// as a zero length array is not standard, there is always at least one.
+std::size_t constexpr messagePadBytes(std::size_t size) {
+    return (messageBits(size) + 7) / 8 - 4 - size * 4 - 4
+	? (messageBits(size) + 7) / 8 - 4 - size * 4 - 4 : 1;
+}
+
 template<std::size_t size>
 struct Message {
 private:
@@ -277,8 +314,7 @@ public:
     uint32_t	encodings[size];
 private:
     uint32_t	update;
-    uint8_t	pad[(messageBits(size) + 7 / 8)
-		    - sizeof start - sizeof encodings - sizeof update];
+    uint8_t	pad[messagePadBytes(size)];
 public:
     Message() :
 	start		{},
@@ -294,4 +330,138 @@ public:
     void gamma();
 };
 
+/// 32 bit FNV-1a digest of size encodings
+uint32_t digest(uint32_t const * encodings, std::size_t size);
+
+/// An APA102::Unchanged remembers a digest of the last transmitted encodings
+/// so that the transmission of the same encodings again may be skipped.
+/// As a safety net (against digest collisions or LEDs that lost their state)
+/// transmission is never skipped more than refresh - 1 times in a row.
+class Unchanged {
+private:
+    unsigned const	refresh;
+    uint32_t		lastDigest;
+    unsigned		unsent;
+    unsigned		skipped_;
+public:
+    Unchanged(unsigned refresh);
+
+    /// return true if size encodings are unchanged since they were last
+    /// transmitted and their transmission should be skipped;
+    /// otherwise, remember them as transmitted.
+    bool operator()(uint32_t const * encodings, std::size_t size);
+
+    template <std::size_t size>
+    bool operator()(Message<size> const & message) {
+	return (*this)(message.encodings, size);
+    }
+
+    /// count of skipped transmissions
+    unsigned skipped() const {return skipped_;}
+};
+
+/// words (after the encodings of a size LED message prefix)
+/// that must be clocked out to pad it (including the trailing sync word).
+std::size_t constexpr paddingWords(std::size_t size) {
+    return (messageBits(size) - 32 - size * 32 + 31) / 32;
+}
+
+/// true if the messageBits(end) of an end LED prefix of a Message<size>
+/// are all in it and its encodings, (at most paddingWords(size))
+/// zeroed words after them and zero update word are enough to clock them out.
+template<std::size_t size>
+constexpr bool coversPrefix(std::size_t end) {
+    return (messageBits(end) + 7) / 8 <= sizeof(Message<size>)
+	&& 32 * (1 + end + paddingWords(end)) >= messageBits(end)
+	&& paddingWords(end) <= paddingWords(size);
+}
+
+/// index after the last of size encodings that differ (or 0, if none).
+inline std::size_t changedEnd(
+	uint32_t const * a, uint32_t const * b, std::size_t size) {
+    while (size && a[size - 1] == b[size - 1]) --size;
+    return size;
+}
+
+/// APA102::Frames is a pair of Messages in DMA capable memory
+/// so that one (the back) may be rendered
+/// while the other (the front) is being transmitted.
+/// flip() exchanges them.
+///
+/// As LEDs only need data to be clocked as far as the last one that changed
+/// (plus padding), flipPrefix() will compare them first
+/// and prepare only a prefix of the new front for transmission.
+template<std::size_t size>
+class Frames {
+private:
+    Message<size> * const message;	// [2]
+    unsigned backIndex;
+    std::size_t zeroedBegin;	///< front encodings zeroed for padding
+    std::size_t zeroedEnd;
+    uint32_t zeroed[paddingWords(size)];
+
+    static_assert(coversPrefix<size>(0),		"empty prefix");
+    static_assert(coversPrefix<size>(1),		"one LED prefix");
+    static_assert(coversPrefix<size>(size / 2 | 1),	"odd prefix");
+    static_assert(coversPrefix<size>(size - 1),	"all but one LED prefix");
+    static_assert(coversPrefix<size>(size),		"full prefix");
+public:
+    Frames() :
+	message {static_cast<Message<size> *>(
+	    heap_caps_malloc(2 * sizeof *message, MALLOC_CAP_DMA))},
+	backIndex {0},
+	zeroedBegin {0},
+	zeroedEnd {0},
+	zeroed {}
+    {
+	if (!message) throw std::bad_alloc();
+	new (&message[0]) Message<size>;
+	new (&message[1]) Message<size>;
+    }
+    Frames(Frames const &) = delete;
+    Frames & operator=(Frames const &) = delete;
+    Message<size> & back() {return message[backIndex];}
+    Message<size> & front() {return message[1 - backIndex];}
+    void flip() {backIndex = 1 - backIndex;}
+
+    /// Copy the front encodings (as they were before padding) to the back
+    /// so that the back may be updated incrementally.
+    void copyFront() {
+	uint32_t * const encodings {back().encodings};
+	std::memcpy(encodings, front().encodings, size * sizeof *encodings);
+	for (std::size_t i {zeroedBegin}; i < zeroedEnd; ++i) {
+	    encodings[i] = zeroed[i - zeroedBegin];
+	}
+    }
+
+    /// The front must no longer be in transmission.
+    /// Restore the front encodings that were zeroed for padding.
+    /// If the back differs from the front (or full), flip them,
+    /// zero (and save) the encodings that pad the shortest prefix of the
+    /// new front that includes all those that changed (or all, if full)
+    /// and return its length in bits. Otherwise, return 0.
+    std::size_t flipPrefix(bool full = false) {
+	uint32_t * encodings {front().encodings};
+	for (std::size_t i {zeroedBegin}; i < zeroedEnd; ++i) {
+	    encodings[i] = zeroed[i - zeroedBegin];
+	}
+	zeroedBegin = zeroedEnd = 0;
+	std::size_t const end {full
+	    ? size : changedEnd(back().encodings, encodings, size)};
+	if (!end) return 0;
+	flip();
+	// encodings beyond size are followed by zeros in the message
+	encodings = front().encodings;
+	zeroedBegin = end;
+	zeroedEnd = std::min(size, end + paddingWords(end));
+	for (std::size_t i {zeroedBegin}; i < zeroedEnd; ++i) {
+	    zeroed[i - zeroedBegin] = encodings[i];
+	    encodings[i] = 0;
+	}
+	return messageBits(end);
+    }
+
+    ~Frames() {heap_caps_free(message);}	// Message is trivially destructible
+};
+
 }
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Capture.h"
+
+namespace Capture {
+
+static uint8_t const magic[] {'A', 'L', 'F', 'C'};
+static uint8_t constexpr version {1};
+static uint8_t constexpr keyType {'K'};
+static uint8_t constexpr deltaType {'D'};
+
+static uint8_t * putVarint(uint8_t * it, uint64_t value) {
+    while (0x80 <= value) {
+	*it++ = static_cast<uint8_t>(value) | 0x80;
+	value >>= 7;
+    }
+    *it++ = static_cast<uint8_t>(value);
+    return it;
+}
+
+static uint8_t * put16(uint8_t * it, uint16_t value) {
+    *it++ = value;
+    *it++ = value >> 8;
+    return it;
+}
+
+static uint8_t * put32(uint8_t * it, uint32_t value) {
+    *it++ = value;
+    *it++ = value >> 8;
+    *it++ = value >> 16;
+    *it++ = value >> 24;
+    return it;
+}
+
+/// get a value at it and advance it.
+/// return false (and leave it somewhere before end) if it would pass end.
+static bool getVarint(uint8_t const * & it, uint8_t const * end,
+    uint64_t & value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && it < end; shift += 7) {
+	uint8_t const byte {*it++};
+	value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+	if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool get16(uint8_t const * & it, uint8_t const * end, uint16_t & value) {
+    if (end - it < 2) return false;
+    value = it[0] | it[1] << 8;
+    it += 2;
+    return true;
+}
+
+static bool get32(uint8_t const * & it, uint8_t const * end, uint32_t & value) {
+    if (end - it < 4) return false;
+    value = static_cast<uint32_t>(it[0])
+	| static_cast<uint32_t>(it[1]) << 8
+	| static_cast<uint32_t>(it[2]) << 16
+	| static_cast<uint32_t>(it[3]) << 24;
+    it += 4;
+    return true;
+}
+
+Sink::~Sink() {}
+
+RingSink::RingSink(std::size_t capacity_)
+:
+    capacity	(capacity_),
+    ring	(new uint8_t[capacity]),
+    begin	(0),
+    size	(0),
+    header_	(),
+    drops_	(0),
+    mutex	()
+{}
+
+void RingSink::put(std::size_t offset, uint8_t const * data, std::size_t size_)
+{
+    offset %= capacity;
+    std::size_t const first {std::min(size_, capacity - offset)};
+    std::memcpy(&ring[offset], data, first);
+    std::memcpy(&ring[0], data + first, size_ - first);
+}
+
+void RingSink::get(std::size_t offset, uint8_t * data, std::size_t size_) const
+{
+    offset %= capacity;
+    std::size_t const first {std::min(size_, capacity - offset)};
+    std::memcpy(data, &ring[offset], first);
+    std::memcpy(data + first, &ring[0], size_ - first);
+}
+
+std::size_t RingSink::recordSize(std::size_t offset) const {
+    uint8_t prefix[4];
+    get(offset, prefix, sizeof prefix);
+    uint8_t const * it {prefix};
+    uint32_t value;
+    get32(it, prefix + sizeof prefix, value);
+    return sizeof prefix + value;
+}
+
+bool RingSink::isKey(std::size_t offset) const {
+    uint8_t type;
+    get(offset + 4, &type, 1);
+    return keyType == type;
+}
+
+void RingSink::discard() {
+    // discard the oldest record and any delta records that follow it
+    // so that we always begin with a key frame.
+    do {
+	std::size_t const discarded {recordSize(begin)};
+	begin = (begin + discarded) % capacity;
+	size -= discarded;
+    } while (size && !isKey(begin));
+}
+
+void RingSink::header(uint8_t const * data, std::size_t size_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    header_.assign(data, data + size_);
+    begin = size = 0;
+}
+
+void RingSink::frame(uint8_t const * data, std::size_t size_, bool key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t const recordSize_ {4 + size_};
+    if (capacity < recordSize_ || (!size && !key)) {
+	// we cannot keep it or, without its key frame, it would be useless
+	++drops_;
+	return;
+    }
+    while (capacity - size < recordSize_) {
+	discard();
+    }
+    uint8_t prefix[4];
+    put32(prefix, size_);
+    std::size_t const end {begin + size};
+    put(end, prefix, sizeof prefix);
+    put(end + sizeof prefix, data, size_);
+    size += recordSize_;
+}
+
+std::string RingSink::copy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string result;
+    result.reserve(header_.size() + size);
+    result.append(header_.begin(), header_.end());
+    for (std::size_t offset = 0; offset < size;) {
+	std::size_t const recordSize_ {recordSize(begin + offset)};
+	std::size_t const start {(begin + offset + 4) % capacity};
+	std::size_t const frameSize {recordSize_ - 4};
+	std::size_t const first {std::min(frameSize, capacity - start)};
+	result.append(reinterpret_cast<char const *>(&ring[start]), first);
+	result.append(reinterpret_cast<char const *>(&ring[0]),
+	    frameSize - first);
+	offset += recordSize_;
+    }
+    return result;
+}
+
+unsigned RingSink::drops() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return drops_;
+}
+
+FileSink::FileSink(std::FILE * file_)
+:
+    file	(file_)
+{}
+
+void FileSink::header(uint8_t const * data, std::size_t size) {
+    std::fwrite(data, 1, size, file);
+}
+
+void FileSink::frame(uint8_t const * data, std::size_t size, bool) {
+    std::fwrite(data, 1, size, file);
+}
+
+Recorder::Recorder(
+    Sink &		sink_,
+    Chip		chip,
+    std::size_t		ledCount_,
+    uint16_t const *	layout,
+    std::size_t		keyInterval_)
+:
+    sink	(sink_),
+    ledCount	(ledCount_),
+    keyInterval	(keyInterval_),
+    previous	(),
+    // type, microseconds, encodings and the (at most 3 byte) varints
+    // of the most runs a delta frame could have.
+    buffer	(1 + 10 + ledCount * 4 + (ledCount / 2 + 1) * 6),
+    microseconds(0),
+    sinceKey	(keyInterval)
+{
+    previous.reserve(ledCount);
+    std::vector<uint8_t> header(sizeof magic + 1 + 1 + 2 + ledCount * 2);
+    uint8_t * it {std::copy(magic, magic + sizeof magic, header.data())};
+    *it++ = version;
+    *it++ = static_cast<uint8_t>(chip);
+    it = put16(it, ledCount);
+    for (std::size_t index = 0; index < ledCount; ++index) {
+	it = put16(it, layout ? layout[index] : index);
+    }
+    sink.header(header.data(), header.size());
+}
+
+void Recorder::record(uint64_t microseconds_, uint32_t const * encodings) {
+    if (!previous.empty()
+	    && std::equal(encodings, encodings + ledCount, previous.begin())) {
+	// nothing changed. don't record it.
+	return;
+    }
+    bool const key {keyInterval <= sinceKey};
+    uint8_t * it {buffer.data()};
+    if (key) {
+	*it++ = keyType;
+	it = putVarint(it, microseconds_);
+	for (std::size_t index = 0; index < ledCount; ++index) {
+	    it = put32(it, encodings[index]);
+	}
+	sinceKey = 0;
+    } else {
+	*it++ = deltaType;
+	it = putVarint(it, microseconds_ - microseconds);
+	std::size_t index {0};
+	while (index < ledCount) {
+	    std::size_t const unchanged {index};
+	    while (index < ledCount && previous[index] == encodings[index]) {
+		++index;
+	    }
+	    it = putVarint(it, index - unchanged);
+	    if (ledCount == index) break;
+	    std::size_t const changed {index};
+	    while (index < ledCount && previous[index] != encodings[index]) {
+		++index;
+	    }
+	    it = putVarint(it, index - changed);
+	    for (std::size_t each = changed; each < index; ++each) {
+		it = put32(it, encodings[each]);
+	    }
+	}
+	sinceKey += it - buffer.data();
+    }
+    previous.assign(encodings, encodings + ledCount);
+    microseconds = microseconds_;
+    sink.frame(buffer.data(), it - buffer.data(), key);
+}
+
+Reader::Reader(uint8_t const * data_, std::size_t size)
+:
+    frames		(nullptr),
+    data		(data_),
+    end			(data_ + size),
+    chip_		(Chip::apa102),
+    layout_		(),
+    encodings_		(),
+    microseconds_	(0),
+    valid		(false)
+{
+    if (end - data < static_cast<std::ptrdiff_t>(sizeof magic + 2)
+	    || !std::equal(magic, magic + sizeof magic, data)
+	    || version != data[sizeof magic]) {
+	return;
+    }
+    data += sizeof magic + 1;
+    chip_ = static_cast<Chip>(*data++);
+    uint16_t ledCount_;
+    if (!get16(data, end, ledCount_)) return;
+    layout_.resize(ledCount_);
+    for (auto & index: layout_) {
+	if (!get16(data, end, index)) return;
+    }
+    frames = data;
+    valid = true;
+}
+
+void Reader::rewind() {
+    if (!frames) return;
+    data = frames;
+    encodings_.clear();
+    microseconds_ = 0;
+    valid = true;
+}
+
+bool Reader::next() {
+    if (!valid || data == end) return false;
+    valid = false;
+    uint8_t const type {*data++};
+    uint64_t microseconds;
+    if (!getVarint(data, end, microseconds)) return false;
+    std::size_t const ledCount_ {ledCount()};
+    if (keyType == type) {
+	encodings_.resize(ledCount_);
+	for (auto & encoding: encodings_) {
+	    if (!get32(data, end, encoding)) return false;
+	}
+	microseconds_ = microseconds;
+    } else if (deltaType == type) {
+	if (encodings_.size() != ledCount_) return false;
+	std::size_t index {0};
+	while (index < ledCount_) {
+	    uint64_t unchanged;
+	    if (!getVarint(data, end, unchanged)
+		|| ledCount_ - index < unchanged) {
+		return false;
+	    }
+	    index += unchanged;
+	    if (ledCount_ == index) break;
+	    uint64_t changed;
+	    if (!getVarint(data, end, changed)
+		|| ledCount_ - index < changed
+		|| !(unchanged || changed)) {
+		return false;
+	    }
+	    for (std::size_t stop = index + changed; index < stop; ++index) {
+		if (!get32(data, end, encodings_[index])) return false;
+	    }
+	}
+	microseconds_ += microseconds;
+    } else {
+	return false;
+    }
+    valid = true;
+    return true;
+}
+
+Player::Player(uint8_t const * data, std::size_t size)
+:
+    reader	(data, size),
+    playable	(reader.next()),
+    pending	(false),
+    current	(),
+    first	(0),
+    last	(0),
+    previous	(0),
+    origin	(0)
+{
+    current.reserve(reader.ledCount());
+}
+
+void Player::start(int64_t microseconds, int64_t at) {
+    reader.rewind();
+    pending = reader.next();
+    current.clear();
+    first = last = previous = reader.microseconds();
+    origin = microseconds - at;
+}
+
+std::vector<uint32_t> const & Player::operator()(int64_t microseconds) {
+    while (pending) {
+	int64_t const at {first + microseconds - origin};
+	if (at < static_cast<int64_t>(reader.microseconds())) break;
+	current = reader.encodings();
+	previous = last;
+	last = reader.microseconds();
+	pending = reader.next();
+	if (!pending) {
+	    int64_t const period {last - first + last - previous};
+	    if (!period) break;	// a still
+	    // loop
+	    origin += period;
+	    reader.rewind();
+	    pending = reader.next();
+	    previous = last = first;
+	}
+    }
+    return current;
+}
+
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Capture records exactly what is transmitted to a chain of LEDs
+/// in a compact binary stream so that it can be analyzed or played back.
+/// It depends only on the standard library
+/// so that a Reader may be used on the host too.
+///
+/// A stream is a header followed by frames.
+/// Integers are little endian. A varint is an unsigned LEB128 integer.
+///
+///	header:	"ALFC"			magic
+///		version			1 byte (1)
+///		chip			1 byte (Chip)
+///		ledCount		2 bytes
+///		layout			ledCount * 2 bytes,
+///					the wiring index of each rendering index
+///	frame:	type			1 byte ('K' or 'D')
+///		'K' (key) frame:
+///		microseconds		varint, since boot
+///		encodings		ledCount * 4 bytes, in wiring order
+///		'D' (delta) frame, against the previous frame:
+///		microseconds		varint, since the previous frame
+///		runs			until ledCount encodings are covered:
+///		    unchanged		varint, count of encodings unchanged
+///		    changed		varint, count of encodings that follow
+///					(omitted if unchanged reaches ledCount)
+///		    encodings		changed * 4 bytes
+///
+/// Encodings are APA102 LED words as transmitted (see APA102.h).
+/// A Recorder starts with a key frame and writes another
+/// every so often so that a stream (from a RingSink) that lost its
+/// oldest frames can still be read from its first key frame
+/// and so that a Reader need not read far to seek.
+/// Frames that are unchanged are not recorded.
+namespace Capture {
+
+enum class Chip : uint8_t {apa102, sk9822};
+
+/// A Sink is where a Recorder writes a stream.
+class Sink {
+public:
+    virtual void header(uint8_t const * data, std::size_t size) = 0;
+    virtual void frame(uint8_t const * data, std::size_t size, bool key) = 0;
+    virtual ~Sink();
+};
+
+/// A RingSink keeps the header and as many of the most recent frames
+/// as will fit in a RAM ring of capacity bytes.
+/// When it must make room, it discards the oldest frames through
+/// the one before the next key frame.
+/// It may be copied from another task while it is written.
+class RingSink : public Sink {
+private:
+    std::size_t const		capacity;
+    std::unique_ptr<uint8_t[]> const	ring;	// [capacity]
+    std::size_t			begin;	///< oldest record
+    std::size_t			size;	///< bytes of records
+    std::vector<uint8_t>	header_;
+    unsigned			drops_;	///< frames too large to keep
+    std::mutex mutable		mutex;
+
+    // records are frames prefixed by their 4 byte size
+    void put(std::size_t offset, uint8_t const * data, std::size_t size);
+    void get(std::size_t offset, uint8_t * data, std::size_t size) const;
+    std::size_t recordSize(std::size_t offset) const;
+    bool isKey(std::size_t offset) const;
+    void discard();
+
+public:
+    RingSink(std::size_t capacity);
+
+    void header(uint8_t const * data, std::size_t size) override;
+    void frame(uint8_t const * data, std::size_t size, bool key) override;
+
+    /// copy of the stream: the header and the frames we have kept
+    std::string copy() const;
+
+    unsigned drops() const;
+};
+
+/// A FileSink writes a stream to a file (that it does not own).
+class FileSink : public Sink {
+private:
+    std::FILE * const file;
+
+public:
+    FileSink(std::FILE * file);
+
+    void header(uint8_t const * data, std::size_t size) override;
+    void frame(uint8_t const * data, std::size_t size, bool key) override;
+};
+
+/// A Recorder writes a stream of the frames it records to its Sink.
+/// Its buffers are allocated once so that recording does not allocate.
+class Recorder {
+private:
+    Sink &			sink;
+    std::size_t const		ledCount;
+    std::size_t const		keyInterval;
+    std::vector<uint32_t>	previous;	///< empty before the first frame
+    std::vector<uint8_t>	buffer;
+    uint64_t			microseconds;	///< of previous
+    std::size_t			sinceKey;	///< bytes since a key frame
+
+public:
+    /// layout may be nullptr for rendering order = wiring order.
+    /// a key frame is written after keyInterval bytes of delta frames.
+    /// for a RingSink, this should be a fraction of its capacity.
+    Recorder(
+	Sink &			sink,
+	Chip			chip,
+	std::size_t		ledCount,
+	uint16_t const *	layout		= nullptr,
+	std::size_t		keyInterval	= 1 << 16);
+
+    /// record ledCount encodings (in wiring order) transmitted at microseconds
+    void record(uint64_t microseconds, uint32_t const * encodings);
+};
+
+/// A Reader reads a stream from memory.
+class Reader {
+private:
+    uint8_t const *		frames;	///< after the header, if read
+    uint8_t const *		data;
+    uint8_t const *		end;
+    Chip			chip_;
+    std::vector<uint16_t>	layout_;
+    std::vector<uint32_t>	encodings_;
+    uint64_t			microseconds_;
+    bool			valid;	///< header and (after next) frame
+
+public:
+    /// read the header of the size byte stream at data
+    Reader(uint8_t const * data, std::size_t size);
+
+    /// return true if the header was read
+    explicit operator bool() const {return valid;}
+
+    Chip chip() const {return chip_;}
+    std::size_t ledCount() const {return layout_.size();}
+
+    /// wiring index of each rendering index
+    std::vector<uint16_t> const & layout() const {return layout_;}
+
+    /// read the next frame.
+    /// return false at the end of the stream or if it is malformed.
+    /// delta frames before the first key frame are malformed.
+    bool next();
+
+    /// (if the header was read) read from the first frame again
+    void rewind();
+
+    /// encodings (in wiring order) of the frame read
+    std::vector<uint32_t> const & encodings() const {return encodings_;}
+
+    /// microseconds (since boot) of the frame read
+    uint64_t microseconds() const {return microseconds_;}
+};
+
+/// A Player plays a stream from memory in time, looping at its end.
+/// The last frame is played as long as the one before it
+/// before the first is played again.
+class Player {
+private:
+    Reader			reader;
+    bool const			playable;
+    bool			pending;	///< reader has a frame not yet due
+    std::vector<uint32_t>	current;
+    int64_t			first;		///< stream time of first frame
+    int64_t			last;		///< stream time of current
+    int64_t			previous;	///< stream time before current
+    int64_t			origin;		///< time of first frame
+
+public:
+    /// play the size byte stream at data
+    Player(uint8_t const * data, std::size_t size);
+
+    /// return true if the stream has a frame to play
+    explicit operator bool() const {return playable;}
+
+    Reader const & stream() const {return reader;}
+
+    /// start playing at microseconds, at microseconds into the stream
+    void start(int64_t microseconds, int64_t at = 0);
+
+    /// the encodings due at microseconds (or empty, if none)
+    std::vector<uint32_t> const & operator()(int64_t microseconds);
+};
+
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <list>
 #include <random>
 #include <sstream>
 
@@ -13,9 +15,8 @@ extern "C" {
 #include "ClockArtTask.h"
 #include "Curve.h"
 #include "InRing.h"
-#include "PerlinNoise.hpp"
+#include "PerlinNoiseQ16.h"
 #include "Pulse.h"
-#include "Timer.h"
 
 using APA102::LED;
 using LEDI = APA102::LED<int>;
@@ -66,26 +67,28 @@ static size_t constexpr sum(size_t const (&a)[n]) {
     return sum_(0, n, a);
 }
 
+static size_t constexpr ringCount	{2};
+static size_t constexpr sectorCount	{12};
+
+static size_t constexpr ring0UnfoldedSize[sectorCount]
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0};
+static size_t constexpr ring0FoldedSize[sectorCount]
+    {59, 59, 59, 57, 57, 55, 55, 55, 55, 56, 57, 58};
+static size_t constexpr ring0SectorSize[sectorCount]
+    {59, 59, 59, 57, 57, 55, 55, 55, 55, 56, 57, 58};
+static size_t constexpr ring1SectorSize[sectorCount]
+    {20, 27, 34, 25, 24, 25, 22, 24, 26, 32, 29, 29};
+
+static size_t constexpr ledCount[ringCount] {
+    sum(ring0SectorSize),
+    sum(ring1SectorSize)
+};
+
 void ClockArtTask::update_() {
-    static size_t constexpr ringCount	{2};
-    static size_t constexpr sectorCount	{12};
-
-    static size_t constexpr ring0UnfoldedSize[sectorCount]
-	{ 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0};
-    static size_t constexpr ring0FoldedSize[sectorCount]
-	{59, 59, 59, 57, 57, 55, 55, 55, 55, 56, 57, 58};
-    static size_t constexpr ring0SectorSize[sectorCount]
-	{59, 59, 59, 57, 57, 55, 55, 55, 55, 56, 57, 58};
-    static size_t constexpr ring1SectorSize[sectorCount]
-	{20, 27, 34, 25, 24, 25, 22, 24, 26, 32, 29, 29};
+    FrameStats::Scope frameScope {frameStats, FrameStats::render};
 
     static size_t constexpr toRingIndex[dialCount] {0, 1, 1};
 
-    static size_t constexpr ledCount[ringCount] {
-	sum(ring0SectorSize),
-	sum(ring1SectorSize)
-    };
-
     uint64_t const microsecondsSinceBoot {esp_time_impl_get_time_since_boot()};
 
     static LEDI const black {0, 0, 0};
@@ -103,9 +106,9 @@ void ClockArtTask::update_() {
 
     std::list<std::function<LEDI(float)>> renderList[ringCount];
 
-    // construct static PerlinNoise objects
+    // construct static PerlinNoiseQ16 objects
     static std::mt19937 rng;
-    static PerlinNoise perlinNoise[] {rng, rng, rng, rng};
+    static PerlinNoiseQ16 perlinNoise[] {rng, rng, rng, rng};
     // Perlin noise repeats every 256 units.
     static unsigned constexpr perlinNoisePeriod {256};
     static uint64_t constexpr perlinNoisePeriodMicroseconds
@@ -196,16 +199,23 @@ void ClockArtTask::update_() {
 	    // cut RGB cylinders through Perlin noise space/time.
 	    float z {(microsecondsSinceBoot % perlinNoisePeriodMicroseconds)
 		/ static_cast<float>(microsecondsPerSecond)};
-	    renderList[0].push_back([z](float place){
-		static float constexpr radius {0.5f};
-		float x {radius * std::cos(tau * place)};
-		float y {radius * std::sin(tau * place)};
+	    // evaluate the noise (R, G and B) at every place in ring 0
+	    // in one batch.
+	    // the render function looks up the noise at its place.
+	    for (auto & z_: slideZ) z_ = z;
+	    static PerlinNoiseQ16 const * const rgbNoise[] {
+		&perlinNoise[0], &perlinNoise[1], &perlinNoise[2]};
+	    static int constexpr octaves {1};
+	    PerlinNoiseQ16::octaveNoise0_1(rgbNoise, 3, ring0Size,
+		slideX, slideY, slideZ, &slideRgb[0][0], octaves);
+	    renderList[0].push_back([this](float place){
 		static int constexpr max {128};
-		static int constexpr octaves {1};
+		float const * const rgb {slideRgb[std::lower_bound(
+		    slidePlace, slidePlace + ring0Size - 1, place) - slidePlace]};
 		return LEDI(
-		    max * perlinNoise[0].octaveNoise0_1(x, y, z, octaves),
-		    max * perlinNoise[1].octaveNoise0_1(x, y, z, octaves),
-		    max * perlinNoise[2].octaveNoise0_1(x, y, z, octaves));
+		    max * rgb[0],
+		    max * rgb[1],
+		    max * rgb[2]);
 	    });
 	} break;
     case Mode::Value::spin: {
@@ -271,6 +281,7 @@ void ClockArtTask::update_() {
     }
 
     APA102::Message<ledCount[0]> message0;
+    frameScope.next(FrameStats::encode);
     APA102::Message<ledCount[1]> message1;
 
     /// adjust brightness
@@ -287,43 +298,53 @@ void ClockArtTask::update_() {
 	message1.encodings
     };
     for (size_t ringIndex {0}; ringIndex < ringCount; ++ringIndex) {
-	uint32_t * e {encodings[ringIndex]};
-	for (size_t ledIndex {0}; ledIndex < ledCount[ringIndex]; ++ledIndex, ++led) {
-	    static auto const maxEncoding {std::numeric_limits<uint8_t>::max()};
-	    *e++ = LED<>(gammaEncode,
-		Range::clip == range.value
-		    ? clip(*led) * dimming
-		    : static_cast<LED<>>((*led * maxEncoding / maxRendering)
-			* dimming));
-	}
+	static auto const maxEncoding {std::numeric_limits<uint8_t>::max()};
+	APA102::encode(encodings[ringIndex], led, ledCount[ringIndex],
+	    [this, dimming, maxRendering](LEDI const & l) {
+		return LED<>(gammaEncode,
+		    Range::clip == range.value
+			? clip(l) * dimming
+			: static_cast<LED<>>((l * maxEncoding / maxRendering)
+			    * dimming));
+	    });
+	led += ledCount[ringIndex];
     }
 
+    bool const unchanged0 {unchanged[0](message0)};
+    bool const unchanged1 {unchanged[1](message1)};
+
     // SPI::Transaction constructor queues the message.
     // SPI::Transaction destructor waits for result.
-    // queue both before waiting for result of either.
-    {
-	SPI::Transaction transaction0(spiDevice[0], SPI::Transaction::Config()
-	    .tx_buffer_(&message0)
-	    .length_(message0.length()));
-	SPI::Transaction transaction1(spiDevice[1], SPI::Transaction::Config()
-	    .tx_buffer_(&message1)
-	    .length_(message1.length()));
+    // queue both before waiting for result of either
+    // (transaction1 is scoped within transaction0).
+    // do not transmit a message that is the same as the last one.
+    frameScope.next(FrameStats::spiWait);
+    auto const transmit1 {[this, unchanged1, &message1](){
+	if (unchanged1) {
+	    frameStats.count(FrameStats::unchanged);
+	} else {
+	    SPI::Transaction transaction1(spiDevice[1],
+		SPI::Transaction::Config()
+		    .tx_buffer_(&message1)
+		    .length_(message1.length()));
+	}
+    }};
+    if (unchanged0) {
+	frameStats.count(FrameStats::unchanged);
+	transmit1();
+    } else {
+	SPI::Transaction transaction0(spiDevice[0],
+	    SPI::Transaction::Config()
+		.tx_buffer_(&message0)
+		.length_(message0.length()));
+	transmit1();
     }
 }
 
 void ClockArtTask::update() {
-    // if the rate at which we complete work
-    // is less than the periodic demand for such work
-    // the work queue will eventually exhaust all memory.
-    if (updated++) {
-	// catch up to the rate of demand
-	ESP_LOGW(name, "update rate too fast. %u", updated - 1);
-	return;
-    }
+    frameStats.started();
     update_();
-    // ignore any queued update work
-    io.poll();
-    updated = 0;
+    frameScheduler.done();
 }
 
 ClockArtTask::ClockArtTask(
@@ -392,21 +413,36 @@ ClockArtTask::ClockArtTask(
 
     microsecondsSinceBootOfLastPeriod(0u),
 
-    updated(0)
+    frameStats(keyValueBroker),
+    unchanged {
+	{CONFIG_ARTLIGHT_APA102_REFRESH},
+	{CONFIG_ARTLIGHT_APA102_REFRESH},
+    },
+    frameScheduler(name, 12.5f, [this](){
+	frameStats.expired();
+	io.post([this](){
+	    this->update();
+	});
+    })
 {
+    static_assert(ring0Size == ledCount[0], "ring0Size");
+
+    // the places in ring 0 (as rendered for slide mode)
+    // and where they cut the noise.
+    static float constexpr radius {0.5f};
+    SectorsInRing inRing0(sectorCount, ring0SectorSize);
+    for (size_t i {0}; i < ring0Size; ++i, ++inRing0) {
+	float const place {(*inRing0)[0]};
+	slidePlace[i] = place;
+	slideX[i] = radius * std::cos(tau * place);
+	slideY[i] = radius * std::sin(tau * place);
+    }
+
     sensorTask.start();
 }
 
 void ClockArtTask::run() {
-    // asio timers are not supported
-    // adapt a FreeRTOS timer to post timeout to this task.
-    Timer updateTimer(name, 8, true, [this](){
-	io.post([this](){
-	    this->update();
-	});
-    });
-
-    updateTimer.start();
+    frameScheduler.start();
 
     // create some dummy work ...
     asio::io_service::work work(io);
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "APA102.h"
 #include "AsioTask.h"
 #include "Button.h"
 #include "DialPreferences.h"
+#include "FrameScheduler.h"
+#include "FrameStats.h"
 #include "I2C.h"
 #include "KeyValueBroker.h"
 #include "LEDC.h"
@@ -42,7 +45,18 @@ private:
 
     uint64_t microsecondsSinceBootOfLastPeriod;
 
-    unsigned updated;
+    static size_t constexpr ring0Size {682};	///< LEDs
+    /// slide mode places in ring 0 and their noise coordinates
+    /// (made once) and the noise (red, green and blue) there this frame
+    float slidePlace[ring0Size];
+    float slideX[ring0Size];
+    float slideY[ring0Size];
+    float slideZ[ring0Size];
+    float slideRgb[ring0Size][3];
+
+    FrameStats frameStats;
+    APA102::Unchanged unchanged[2];	// for each spiDevice
+    FrameScheduler frameScheduler;
     void update_();
     void update();
 
@@ -1,3 +1,4 @@
+#include <list>
 #include <random>
 #include <sstream>
 
@@ -12,9 +13,8 @@ extern "C" {
 #include "CornholeArtTask.h"
 #include "Curve.h"
 #include "InRing.h"
-#include "PerlinNoise.hpp"
+#include "PerlinNoiseQ16.h"
 #include "Pulse.h"
-#include "Timer.h"
 
 using APA102::LED;
 using LEDI = APA102::LED<int>;
@@ -28,8 +28,6 @@ static float constexpr sqrt2	= std::sqrt(2.0f);
 static unsigned constexpr millisecondsPerSecond	= 1000u;
 static unsigned constexpr microsecondsPerSecond	= 1000000u;
 
-static size_t constexpr ringSize = 80;
-
 static Pulse hourPulse	(12);
 static Pulse minutePulse(60);
 static Pulse secondPulse(60);
@@ -76,6 +74,8 @@ static float phaseIn(uint64_t time, uint64_t period) {
 static unsigned constexpr scoreMax = 21;
 
 void CornholeArtTask::update_() {
+    FrameStats::Scope frameScope {frameStats, FrameStats::render};
+
     uint64_t const microsecondsSinceBoot {esp_time_impl_get_time_since_boot()};
 
     static LEDI const black(0, 0, 0);
@@ -99,9 +99,9 @@ void CornholeArtTask::update_() {
 
     std::list<std::function<LEDI(float)>> renderList;
 
-    // construct static PerlinNoise objects
+    // construct static PerlinNoiseQ16 objects
     static std::mt19937 rng;
-    static PerlinNoise perlinNoise[] {rng, rng, rng, rng};
+    static PerlinNoiseQ16 perlinNoise[] {rng, rng, rng, rng};
     // Perlin noise repeats every 256 units.
     static unsigned constexpr perlinNoisePeriod = 256;
     static uint64_t constexpr perlinNoisePeriodMicroseconds
@@ -206,16 +206,24 @@ void CornholeArtTask::update_() {
 	    // cut RGB cylinders through Perlin noise space/time.
 	    float z = (microsecondsSinceBoot % perlinNoisePeriodMicroseconds)
 		/ static_cast<float>(microsecondsPerSecond);
-	    renderList.push_back([z](float place){
-		static float constexpr radius = 0.5f;
-		float x = radius * std::cos(tau * place);
-		float y = radius * std::sin(tau * place);
+	    // evaluate the noise (R, G and B) at every place in the ring
+	    // in one batch.
+	    // the render function looks up the noise at its place.
+	    for (auto & z_: slideZ) z_ = z;
+	    static PerlinNoiseQ16 const * const rgbNoise[] =
+		{&perlinNoise[0], &perlinNoise[1], &perlinNoise[2]};
+	    static int constexpr octaves = 1;
+	    PerlinNoiseQ16::octaveNoise0_1(rgbNoise, 3, ringSize,
+		slideX, slideY, slideZ, &slideRgb[0][0], octaves);
+	    renderList.push_back([this](float place){
 		static int constexpr max = 128;
-		static int constexpr octaves = 1;
+		// places are evenly spaced (ordinal / ringSize)
+		float const * const rgb = slideRgb[
+		    static_cast<size_t>(place * ringSize + 0.5f) % ringSize];
 		return LEDI(
-		    max * perlinNoise[0].octaveNoise0_1(x, y, z, octaves),
-		    max * perlinNoise[1].octaveNoise0_1(x, y, z, octaves),
-		    max * perlinNoise[2].octaveNoise0_1(x, y, z, octaves));
+		    max * rgb[0],
+		    max * rgb[1],
+		    max * rgb[2]);
 	    });
 	} break;
     case Mode::Value::spin: {
@@ -309,6 +317,7 @@ void CornholeArtTask::update_() {
 	maxRendering = std::max(maxRendering, led.max());
     }
 
+    frameScope.next(FrameStats::encode);
     APA102::Message<ringSize> message;
 
     /// adjust brightness
@@ -319,38 +328,36 @@ void CornholeArtTask::update_() {
 	// 1 as the lux doubles up until 2^13 (~full daylight, indirect sun).
 	// an LED value of 128 will be dimmed to 24 in complete darkness (lux 0)
 	: (3.0f + std::min(13.0f, std::log2(1.0f + luxSensor.getLux()))) / 16.0f;
-    LEDI * led = leds;
     if (range.value == Range::clip) {
-	for (auto & e: message.encodings) {
-	    e = LED<>(gammaEncode,
-		clip(*led++) * dimming);
-	}
+	APA102::encode(message.encodings, leds, ringSize,
+	    [this, dimming](LEDI const & led) {
+		return LED<>(gammaEncode, clip(led) * dimming);
+	    });
     } else if (range.value == Range::normalize) {
 	static auto maxEncoding = std::numeric_limits<uint8_t>::max();
-	for (auto & e: message.encodings) {
-	    e = LED<>(gammaEncode,
-		(*led++ * maxEncoding / maxRendering) * dimming);
-	}
+	APA102::encode(message.encodings, leds, ringSize,
+	    [this, dimming, maxRendering](LEDI const & led) {
+		return LED<>(gammaEncode,
+		    (led * maxEncoding / maxRendering) * dimming);
+	    });
     }
 
-    SPI::Transaction transaction(spiDevice, SPI::Transaction::Config()
-	.tx_buffer_(&message)
-	.length_(message.length()));
+    bool const unchanged_ {unchanged(message)};
+
+    frameScope.next(FrameStats::spiWait);
+    if (unchanged_) {
+	frameStats.count(FrameStats::unchanged);
+    } else {
+	SPI::Transaction transaction(spiDevice, SPI::Transaction::Config()
+	    .tx_buffer_(&message)
+	    .length_(message.length()));
+    }
 }
 
 void CornholeArtTask::update() {
-    // if the rate at which we complete work
-    // is less than the periodic demand for such work
-    // the work queue will eventually exhaust all memory.
-    if (updated++) {
-	// catch up to the rate of demand
-	ESP_LOGW(name, "update rate too fast. %u", updated - 1);
-	return;
-    }
+    frameStats.started();
     update_();
-    // ignore any queued update work
-    io.poll();
-    updated = 0;
+    frameScheduler.done();
 }
 
 void CornholeArtTask::boardEvent() {
@@ -511,22 +518,31 @@ CornholeArtTask::CornholeArtTask(
     microsecondsSinceBootOfHoleEvent(0u),
     microsecondsSinceBootOfLastPeriod(0u),
 
-    updated(0)
+    frameStats(keyValueBroker),
+    unchanged(CONFIG_ARTLIGHT_APA102_REFRESH),
+    frameScheduler(name, 100.0f, [this](){
+	frameStats.expired();
+	io.post([this](){
+	    this->update();
+	});
+    })
 {
+    // where the places in the ring (as rendered for slide mode)
+    // cut the noise.
+    static float constexpr radius = 0.5f;
+    OrdinalsInRing inRing(ringSize);
+    for (size_t i = 0; i < ringSize; ++i, ++inRing) {
+	float const place = (*inRing)[0];
+	slideX[i] = radius * std::cos(tau * place);
+	slideY[i] = radius * std::sin(tau * place);
+    }
+
     sensorTask.start();
     pinTask.start();
 }
 
 void CornholeArtTask::run() {
-    // asio timers are not supported
-    // adapt a FreeRTOS timer to post timeout to this task.
-    Timer updateTimer(name, 1, true, [this](){
-	io.post([this](){
-	    this->update();
-	});
-    });
-
-    updateTimer.start();
+    frameScheduler.start();
 
     // create some dummy work ...
     asio::io_service::work work(io);
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "APA102.h"
 #include "AsioTask.h"
 #include "DialPreferences.h"
+#include "FrameScheduler.h"
+#include "FrameStats.h"
 #include "Button.h"
 #include "I2C.h"
 #include "KeyValueBroker.h"
@@ -56,6 +59,14 @@ private:
     uint64_t microsecondsSinceBootOfHoleEvent;
     uint64_t microsecondsSinceBootOfLastPeriod;
 
+    static size_t constexpr ringSize = 80;	///< LEDs
+    /// slide mode noise coordinates at each place in the ring
+    /// (made once) and the noise (red, green and blue) there this frame
+    float slideX[ringSize];
+    float slideY[ringSize];
+    float slideZ[ringSize];
+    float slideRgb[ringSize][3];
+
     void boardEvent();
     void holeEvent();
 
@@ -63,7 +74,9 @@ private:
     void scoreDecrement(size_t index, int count);
     void scoreObserved (size_t index, char const * value);
 
-    unsigned updated;
+    FrameStats frameStats;
+    APA102::Unchanged unchanged;
+    FrameScheduler frameScheduler;
     void update_();
     void update();
 
@@ -37,34 +37,26 @@ static constexpr char const * const shapeKey[DialPreferences::dialCount] {
 void DialPreferences::widthObserved(size_t index, char const * value_) {
     float value = fromString<float>(value_);
     if (0.0f <= value && value <= 64.0f) {
-	io_.post([this, index, value](){
-	    width[index] = value;
-	});
+	width[index] = value;
     }
 }
 
 void DialPreferences::colorObserved(size_t index, char const * value_) {
     if (APA102::isColor(value_)) {
 	APA102::LED<> value(value_);
-	io_.post([this, index, value](){
-	    color[index] = value;
-	});
+	color[index] = value;
     }
 }
 
 void DialPreferences::shapeObserved(size_t index, char const * value_) {
     Shape value(value_);
-    io_.post([this, index, value](){
-	shape[index] = value;
-    });
+    shape[index] = value;
 }
 
 DialPreferences::DialPreferences(
     asio::io_context &		io,
     KeyValueBroker &		keyValueBroker)
 :
-    io_ {io},
-
     width {},
     color {},
     shape {
@@ -74,29 +66,29 @@ DialPreferences::DialPreferences(
     },
 
     widthObserver {
-	{keyValueBroker, widthKey[0], "16",
+	{keyValueBroker, widthKey[0], "16", io,
 	    [this](char const * value) {widthObserved(0, value);}},
-	{keyValueBroker, widthKey[1], "8",
+	{keyValueBroker, widthKey[1], "8", io,
 	    [this](char const * value) {widthObserved(1, value);}},
-	{keyValueBroker, widthKey[2], "2",
+	{keyValueBroker, widthKey[2], "2", io,
 	    [this](char const * value) {widthObserved(2, value);}},
     },
 
     colorObserver {
-	{keyValueBroker, colorKey[0], "#60ffca",
+	{keyValueBroker, colorKey[0], "#60ffca", io,
 	    [this](char const * value) {colorObserved(0, value);}},
-	{keyValueBroker, colorKey[1], "#ca60ff",
+	{keyValueBroker, colorKey[1], "#ca60ff", io,
 	    [this](char const * value) {colorObserved(1, value);}},
-	{keyValueBroker, colorKey[2], "#ffffff",
+	{keyValueBroker, colorKey[2], "#ffffff", io,
 	    [this](char const * value) {colorObserved(2, value);}},
     },
 
     shapeObserver {
-	{keyValueBroker, shapeKey[0], shape[0].toString(),
+	{keyValueBroker, shapeKey[0], shape[0].toString(), io,
 	    [this](char const * value) {shapeObserved(0, value);}},
-	{keyValueBroker, shapeKey[1], shape[1].toString(),
+	{keyValueBroker, shapeKey[1], shape[1].toString(), io,
 	    [this](char const * value) {shapeObserved(1, value);}},
-	{keyValueBroker, shapeKey[2], shape[2].toString(),
+	{keyValueBroker, shapeKey[2], shape[2].toString(), io,
 	    [this](char const * value) {shapeObserved(2, value);}},
     }
 {}
@@ -9,9 +9,6 @@
 /// that supports preferences for LED dial indicators
 
 class DialPreferences {
-private:
-    asio::io_context & io_;
-
 public:
     static constexpr size_t dialCount {3};
 
@@ -38,6 +35,7 @@ protected:
     KeyValueBroker::Observer const	colorObserver[dialCount];
     KeyValueBroker::Observer const	shapeObserver[dialCount];
 
+    /// preferences are observed from io
     DialPreferences(
 	asio::io_context &	io,
 	KeyValueBroker &	keyValueBroker);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "APA102.h"
+#include "Blend.h"
+#include "Curve.h"
+
+/// Dial shapes are function objects that map a place on a dial [0.0f, 1.0f)
+/// to a blend factor.
+/// Unlike std::function wrappers, their types are known statically so
+/// rendering a rim with one (renderRim) needs no indirection per place.
+
+class BellShape {
+private:
+    HalfDial	const dial;
+    BellCurve<>	const bell;
+public:
+    BellShape(HalfDial const & dial_, BellCurve<> const & bell_)
+	: dial{dial_}, bell{bell_} {}
+    float operator()(float place) const {
+	return bell(dial(place));
+    }
+};
+
+class WaveShape {
+private:
+    HalfDial	const dial;
+    BellCurve<>	const bell;
+    WaveDial	const wave;
+public:
+    WaveShape(HalfDial const & dial_, BellCurve<> const & bell_,
+	    WaveDial const & wave_)
+	: dial{dial_}, bell{bell_}, wave{wave_} {}
+    float operator()(float place) const {
+	return bell(dial(place)) * wave(place);
+    }
+};
+
+class BloomShape {
+private:
+    HalfDial	const dial;
+    BumpCurve	const bump;
+    BloomCurve	const bloom;
+public:
+    BloomShape(HalfDial const & dial_, BumpCurve const & bump_,
+	    BloomCurve const & bloom_)
+	: dial{dial_}, bump{bump_}, bloom{bloom_} {}
+    float operator()(float place) const {
+	float const offset {dial(place)};
+	return bump(offset) * bloom(offset);
+    }
+};
+
+/// render each of the size places on a rim with a Shape into values,
+/// except for the closest one, which is rendered as faded.
+template <typename Shape>
+void renderRim(
+    Shape					const & shape,
+    Blend<APA102::LED<int16_t>>			const & blend,
+    APA102::LED<int16_t>			const & faded,
+    unsigned					size,
+    unsigned					closest,
+    APA102::LED<int16_t> *			values)
+{
+    for (auto j {0u}; j < size; ++j) {
+	values[j] = j == closest ? faded
+	    : blend(shape(static_cast<float>(j) / size));
+    }
+}
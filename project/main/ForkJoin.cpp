@@ -0,0 +1,34 @@
+#include <new>
+
+#include "ForkJoin.h"
+
+ForkJoin::ForkJoin(
+    char const *	name,
+    UBaseType_t		priority,
+    size_t		stackSize,
+    BaseType_t		core)
+:
+    WorkTask		{name, priority, stackSize, core},
+    joined		{xSemaphoreCreateBinary()},
+    work		{nullptr},
+    call		{nullptr},
+    handlerMemory	{}
+{
+    if (!joined) throw std::bad_alloc();
+}
+
+void ForkJoin::fork(void const * work_, Call call_) {
+    work = work_;
+    call = call_;
+    io.post(handlerMemory.wrap([this](){
+	call(work, 1);
+	xSemaphoreGive(joined);
+    }));
+    call_(work_, 0);
+    xSemaphoreTake(joined, portMAX_DELAY);
+}
+
+/* virtual */ ForkJoin::~ForkJoin() {
+    stop();
+    vSemaphoreDelete(joined);
+}
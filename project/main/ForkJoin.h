@@ -0,0 +1,44 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "HandlerMemory.h"
+#include "WorkTask.h"
+
+/// A ForkJoin is a helper task (typically, pinned to the other core)
+/// that shares the work of the task that uses it.
+/// Calling it with work runs work(1) in the helper task
+/// while work(0) is run in the caller.
+/// It returns when both are done.
+/// Each side should only write to what the other does not touch
+/// so that the result does not depend on how the two interleave.
+/// Forking does not allocate: work is referred to (not copied)
+/// and the helper's side is posted in handlerMemory.
+class ForkJoin : public WorkTask {
+private:
+    using Call = void (*)(void const * work, unsigned side);
+
+    SemaphoreHandle_t const	joined;
+    void const *		work;	///< while forked
+    Call			call;	///< work(side)
+    HandlerMemory<>		handlerMemory;
+
+    void fork(void const * work, Call call);
+
+public:
+    ForkJoin(
+	char const *	name,
+	UBaseType_t	priority,
+	size_t		stackSize,
+	BaseType_t	core);
+
+    template <typename Work>
+    void operator()(Work const & work) {
+	fork(&work, [](void const * work_, unsigned side) {
+	    (*static_cast<Work const *>(work_))(side);
+	});
+    }
+
+    virtual ~ForkJoin();
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// A FrameRing is a lock-free ring of capacity preallocated slots of type T
+/// that hands them off from a single producer task to a single consumer task.
+/// The producer fills the back() slot and push()es it;
+/// the consumer uses the front() slot and pop()s it.
+/// When the ring is full, back() returns nullptr and this is counted
+/// as a drop (the producer should skip its frame).
+/// So that the producer need not wake the consumer for every slot,
+/// push() returns true only when the consumer is idle and must be woken.
+/// A woken consumer drains the ring and then asks to be idle() again.
+/// A capacity that is a power of two lets the indices wrap freely.
+template <typename T, std::size_t capacity>
+class FrameRing {
+    static_assert(capacity && !(capacity & (capacity - 1)),
+	"capacity must be a power of two");
+
+private:
+    std::unique_ptr<T[]> const	slot;	// [capacity]
+    std::atomic<unsigned>	head;	///< count pushed, by producer
+    std::atomic<unsigned>	tail;	///< count popped, by consumer
+    std::atomic<unsigned>	drops_;
+    std::atomic<bool>		awake;	///< consumer is (or will be) woken
+
+public:
+    FrameRing() :
+	slot	{new T[capacity]},
+	head	{0},
+	tail	{0},
+	drops_	{0},
+	awake	{false}
+    {}
+
+    FrameRing(FrameRing const &) = delete;
+    FrameRing & operator=(FrameRing const &) = delete;
+
+    /// producer: the slot to fill next or nullptr (a drop), if full.
+    T * back() {
+	unsigned const h {head.load(std::memory_order_relaxed)};
+	if (capacity == h - tail.load(std::memory_order_acquire)) {
+	    drops_.fetch_add(1, std::memory_order_relaxed);
+	    return nullptr;
+	}
+	return &slot[h % capacity];
+    }
+
+    /// producer: hand off the filled back() slot.
+    /// return true if the consumer is idle and must be woken to drain it.
+    bool push() {
+	// sequentially consistent (with idle) so that either we see the
+	// consumer idle or it sees this slot.
+	head.store(head.load(std::memory_order_relaxed) + 1);
+	return !awake.exchange(true);
+    }
+
+    /// consumer: the slot to use next or nullptr, if empty.
+    T * front() {
+	unsigned const t {tail.load(std::memory_order_relaxed)};
+	if (head.load(std::memory_order_acquire) == t) {
+	    return nullptr;
+	}
+	return &slot[t % capacity];
+    }
+
+    /// consumer: give the used front() slot back
+    void pop() {
+	tail.store(tail.load(std::memory_order_relaxed) + 1,
+	    std::memory_order_release);
+    }
+
+    /// consumer: after draining the ring, become idle.
+    /// return false if a slot was pushed meanwhile
+    /// that the consumer must drain (without being woken).
+    bool idle() {
+	awake.store(false);
+	if (head.load() == tail.load(std::memory_order_relaxed)) {
+	    return true;
+	}
+	// a slot was pushed. if it woke us (again), that will drain it.
+	return awake.exchange(true);
+    }
+
+    /// slots pushed but not yet popped
+    unsigned occupancy() const {
+	// tail first. head cannot fall behind it.
+	unsigned const t {tail.load(std::memory_order_acquire)};
+	return head.load(std::memory_order_acquire) - t;
+    }
+
+    unsigned drops() const {return drops_.load(std::memory_order_relaxed);}
+};
@@ -0,0 +1,68 @@
+#include "esp_log.h"
+
+#include "Error.h"
+#include "FrameScheduler.h"
+
+/* static */ void FrameScheduler::expireThat(void * that) {
+    static_cast<FrameScheduler *>(that)->expire();
+}
+
+FrameScheduler::FrameScheduler(
+    char const *		name_,
+    float			rate,
+    std::function<void()>	expire_)
+:
+    name	(name_),
+    period	(static_cast<uint32_t>(1000000.0f / rate + 0.5f)),
+    expire	(expire_),
+    timer	([this](){
+	    esp_timer_create_args_t args {};
+	    args.callback		= expireThat;
+	    args.arg			= this;
+	    args.dispatch_method	= ESP_TIMER_TASK;
+	    args.name			= name;
+	    esp_timer_handle_t result;
+	    Error::throwIf(esp_timer_create(&args, &result));
+	    return result;
+	}()),
+    deadline	(0),
+    overruns_	(0),
+    skips_	(0)
+{
+    ESP_LOGI(name, "FrameScheduler::FrameScheduler period=%u", period);
+}
+
+void FrameScheduler::start() {
+    deadline = esp_timer_get_time() + period;
+    Error::throwIf(esp_timer_start_once(timer, period));
+}
+
+void FrameScheduler::done() {
+    int64_t const now {esp_timer_get_time()};
+    deadline += period;
+    if (deadline <= now) {
+	// overrun. skip any deadlines missed entirely
+	// and start the next frame now (late).
+	uint32_t const skipped
+	    {static_cast<uint32_t>((now - deadline) / period)};
+	deadline += static_cast<int64_t>(skipped) * period;
+	skips_ += skipped;
+	if (0 == ++overruns_ % 64) {
+	    ESP_LOGW(name, "frame overruns %u, skips %u", overruns_, skips_);
+	}
+	expire();
+    } else {
+	Error::throwIf(esp_timer_start_once(timer, deadline - now));
+    }
+}
+
+void FrameScheduler::stop() {
+    ESP_LOGI(name, "FrameScheduler::stop");
+    esp_timer_stop(timer);
+}
+
+FrameScheduler::~FrameScheduler() {
+    ESP_LOGI(name, "FrameScheduler::~FrameScheduler delete");
+    esp_timer_stop(timer);
+    esp_timer_delete(timer);
+}
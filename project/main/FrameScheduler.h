@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "esp_timer.h"
+
+/// A FrameScheduler calls its expire function object (from the esp_timer
+/// task) when each frame is due.
+/// Frames are due on an absolute microsecond deadline schedule
+/// (every period after start) so that the cadence does not drift
+/// or jitter with FreeRTOS tick granularity.
+/// The next frame is not scheduled until the work of the current frame
+/// is done.
+/// If that work overruns the next deadline, the next frame is due now
+/// and any deadlines that were missed entirely are skipped,
+/// keeping the schedule's phase.
+/// Frame work is never queued faster than it can be done.
+class FrameScheduler {
+private:
+    char const *		name;
+    uint32_t const		period;		///< microseconds
+    std::function<void()>	expire;
+    esp_timer_handle_t		timer;
+    int64_t			deadline;	///< of the current frame
+    unsigned			overruns_;
+    unsigned			skips_;
+
+    static void expireThat(void *);
+
+public:
+    /// schedule frames at rate per second
+    FrameScheduler(
+	char const *		name,
+	float			rate,
+	std::function<void()>	expire);
+
+    /// schedule the first frame
+    void start();
+
+    /// the work of the current frame is done, schedule the next.
+    void done();
+
+    void stop();
+
+    unsigned overruns() const {return overruns_;}
+    unsigned skips() const {return skips_;}
+
+    ~FrameScheduler();
+};
@@ -0,0 +1,131 @@
+#include <sstream>
+
+#include "esp_timer.h"
+
+#include "FrameStats.h"
+
+#ifdef CONFIG_ARTLIGHT_FRAME_STATS
+
+unsigned constexpr FrameStats::Histogram::subBucketsLog2;
+size_t constexpr FrameStats::Histogram::bucketCount;
+
+/* static */ uint32_t FrameStats::Histogram::maxOf(size_t index) {
+    if (index < (1u << subBucketsLog2)) return index;
+    unsigned const shift {static_cast<unsigned>(index >> subBucketsLog2) - 1};
+    uint64_t const next {static_cast<uint64_t>((1u << subBucketsLog2)
+	+ (index & ((1u << subBucketsLog2) - 1)) + 1) << shift};
+    return next - 1;
+}
+
+FrameStats::Histogram::Histogram() :
+    count_	{0},
+    min_	{UINT32_MAX},
+    max_	{0},
+    bucket	{}
+{}
+
+uint32_t FrameStats::Histogram::percentile(unsigned percent) const {
+    uint32_t const count {count_.load(std::memory_order_relaxed)};
+    if (!count) return 0;
+    uint32_t const min {min_.load(std::memory_order_relaxed)};
+    uint32_t const max {max_.load(std::memory_order_relaxed)};
+    uint64_t const rank {(static_cast<uint64_t>(count) * percent + 99) / 100};
+    uint64_t counted {0};
+    for (size_t index = 0; index < bucketCount; ++index) {
+	if (rank <= (counted += bucket[index].load(std::memory_order_relaxed))) {
+	    uint32_t const value {maxOf(index)};
+	    return value < min ? min : max < value ? max : value;
+	}
+    }
+    return max;
+}
+
+static char const * const stageName[FrameStats::stageCount] {
+    "render",
+    "encode",
+    "handoff",
+    "spiWait",
+    "i2cWrite",
+    "latency",
+};
+
+static char const * const stageUnit[FrameStats::stageCount] {
+    "cycles",
+    "cycles",
+    "cycles",
+    "cycles",
+    "cycles",
+    "microseconds",
+};
+
+static char const * const counterName[FrameStats::counterCount] {
+    "unchanged",
+    "dropped",
+    "streamGaps",
+    "streamLates",
+    "streamErrors",
+    "dialCacheHits",
+    "dialCacheMisses",
+};
+
+FrameStats::FrameStats(KeyValueBroker & keyValueBroker)
+:
+    histogram	{new Histogram[stageCount]},
+    due		{0},
+    counter	{},
+    source	{keyValueBroker, "_stats", [this](){return serialize();}}
+{}
+
+void FrameStats::expired() {
+    due = esp_timer_get_time();
+}
+
+void FrameStats::started() {
+    uint32_t const now = esp_timer_get_time();
+    record(latency, now - due);
+}
+
+std::string FrameStats::serialize() const {
+    // histograms are recorded by other tasks while we read them.
+    // each 32 bit value is read atomically but a summary
+    // may be inconsistent by the few frames recorded meanwhile.
+    std::ostringstream stream;
+    size_t count = 0;
+    stream << '{';
+    for (size_t stage = 0; stage < stageCount; ++stage) {
+	Histogram const & h {histogram[stage]};
+	if (!h.count()) continue;
+	if (count++) {
+	    stream << ',';
+	}
+	stream
+	    << '"' << stageName[stage] << R"----(":{"unit":")----"
+	    << stageUnit[stage] << '"'
+	    << R"----(,"count":)----"	<< h.count()
+	    << R"----(,"min":)----"	<< h.min()
+	    << R"----(,"p50":)----"	<< h.percentile(50)
+	    << R"----(,"p99":)----"	<< h.percentile(99)
+	    << R"----(,"max":)----"	<< h.max()
+	    << '}';
+    }
+    for (size_t index = 0; index < counterCount; ++index) {
+	if (!counter[index]) continue;
+	if (count++) {
+	    stream << ',';
+	}
+	stream << '"' << counterName[index] << R"----(":)----" << counter[index];
+    }
+    // preference changes that asynchronous observers did not see
+    // because they were replaced by newer ones
+    KeyValueBroker const & keyValueBroker {source.keyValueBroker};
+    if (unsigned const coalesced = keyValueBroker.coalesced()) {
+	if (count++) {
+	    stream << ',';
+	}
+	stream << R"----("coalesced":)----" << coalesced;
+    }
+    stream << '}';
+    return stream.str();
+}
+
+#endif
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "sdkconfig.h"
+
+#include "KeyValueBroker.h"
+
+/// FrameStats times the stages of the frames of an art task.
+/// Durations of the render, encode, handoff, spiWait and i2cWrite stages
+/// are measured in CPU cycles (CCOUNT) of the core the task runs on.
+/// A handoff is the time it takes to pass a frame to another task.
+/// The latency from when a frame was due (its timer expired)
+/// to when its work started is measured in microseconds
+/// as these events happen on different cores.
+/// Each Stage is counted in its own fixed-size Histogram
+/// (which may be recorded to from more than one task)
+/// whose summary (count, min, p50, p99 and max) is the value
+/// of the read-only "_stats" KeyValueBroker key,
+/// along with the count of each Counter event
+/// and those of the KeyValueBroker's Mailboxes.
+///
+/// Without CONFIG_ARTLIGHT_FRAME_STATS, FrameStats does nothing
+/// and its use compiles to nothing.
+class FrameStats {
+public:
+    enum Stage {render, encode, handoff, spiWait, i2cWrite, latency,
+	stageCount};
+
+    /// Counted events (these may be counted from any task).
+    /// stream events are those of a PixelStream.
+    /// dialCache events are those of (golden) dial renderings.
+    enum Counter {unchanged, dropped, streamGaps, streamLates, streamErrors,
+	dialCacheHits, dialCacheMisses, counterCount};
+
+#ifdef CONFIG_ARTLIGHT_FRAME_STATS
+    /// A Histogram counts values in logarithmically spaced buckets,
+    /// four for each power of two, so that a percentile is resolved
+    /// to within 25% of its value.
+    /// The exact min and max are also kept.
+    /// Each is atomic so that tasks on either core may record.
+    class Histogram {
+    public:
+	static unsigned constexpr subBucketsLog2 {2};
+	static size_t constexpr bucketCount
+	    {(32 - subBucketsLog2 + 1) << subBucketsLog2};
+
+    private:
+	std::atomic<uint32_t>	count_;
+	std::atomic<uint32_t>	min_;
+	std::atomic<uint32_t>	max_;
+	std::atomic<uint32_t>	bucket[bucketCount];
+
+	static size_t bucketOf(uint32_t value) {
+	    if (value < (1u << subBucketsLog2)) return value;
+	    unsigned const msb {31u - __builtin_clz(value)};
+	    unsigned const shift {msb - subBucketsLog2};
+	    return ((shift + 1) << subBucketsLog2)
+		+ ((value >> shift) & ((1u << subBucketsLog2) - 1));
+	}
+
+	/// the largest value that is counted in bucket index
+	static uint32_t maxOf(size_t index);
+
+    public:
+	Histogram();
+
+	void record(uint32_t value) {
+	    count_.fetch_add(1, std::memory_order_relaxed);
+	    uint32_t min {min_.load(std::memory_order_relaxed)};
+	    while (min > value && !min_.compare_exchange_weak(
+		min, value, std::memory_order_relaxed)) {}
+	    uint32_t max {max_.load(std::memory_order_relaxed)};
+	    while (max < value && !max_.compare_exchange_weak(
+		max, value, std::memory_order_relaxed)) {}
+	    bucket[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint32_t count() const {return count_.load(std::memory_order_relaxed);}
+	uint32_t min() const {return min_.load(std::memory_order_relaxed);}
+	uint32_t max() const {return max_.load(std::memory_order_relaxed);}
+
+	/// an upper bound for the value at percent percentile
+	uint32_t percentile(unsigned percent) const;
+    };
+
+    /// CPU cycles (or, off target, nanoseconds)
+    static uint32_t cycles() {
+#ifdef __XTENSA__
+	uint32_t result;
+	asm volatile ("rsr %0, ccount" : "=r" (result));
+	return result;
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+	    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+#endif
+
+    /// A Scope times its lifetime as a Stage
+    /// or, with next, as a sequence of Stages.
+    class Scope {
+#ifdef CONFIG_ARTLIGHT_FRAME_STATS
+    private:
+	FrameStats &	frameStats;
+	Stage		stage;
+	uint32_t	begin;
+
+    public:
+	Scope(FrameStats & frameStats_, Stage stage_)
+	:
+	    frameStats	(frameStats_),
+	    stage	(stage_),
+	    begin	(cycles())
+	{}
+
+	/// end the current stage and begin stage_
+	void next(Stage stage_) {
+	    uint32_t const end {cycles()};
+	    frameStats.record(stage, end - begin);
+	    stage = stage_;
+	    begin = end;
+	}
+
+	~Scope() {
+	    frameStats.record(stage, cycles() - begin);
+	}
+#else
+    public:
+	Scope(FrameStats &, Stage) {}
+	void next(Stage) {}
+#endif
+    };
+
+#ifdef CONFIG_ARTLIGHT_FRAME_STATS
+private:
+    std::unique_ptr<Histogram[]> const	histogram;	// [stageCount]
+    uint32_t volatile			due;
+    std::atomic<uint32_t>		counter[counterCount];
+    KeyValueBroker::Source const	source;
+
+public:
+    FrameStats(KeyValueBroker & keyValueBroker);
+
+    void record(Stage stage, uint32_t value) {
+	histogram[stage].record(value);
+    }
+
+    void count(Counter counter_, unsigned n = 1) {
+	counter[counter_] += n;
+    }
+
+    /// note that a frame is due (from the timer expiration)
+    void expired();
+
+    /// note that the work of the due frame has started
+    void started();
+
+    /// JSON summary of all stages that have been recorded
+    /// and all events that have been counted
+    std::string serialize() const;
+#else
+public:
+    FrameStats(KeyValueBroker &) {}
+
+    void record(Stage, uint32_t) {}
+    void count(Counter, unsigned = 1) {}
+    void expired() {}
+    void started() {}
+#endif
+};
@@ -13,3 +13,16 @@ void GammaEncode::gamma(float value) {
 GammaEncode::GammaEncode(float value) {
     gamma(value);
 }
+
+void GammaEncode12::gamma(float value) {
+    curve[0] = 0;
+    for (int16_t i = 1; i < size; ++i) {
+	auto const e {static_cast<int16_t>(
+	    0.5f + max * std::pow(static_cast<float>(i) / max, value))};
+	curve[i] = e ? e : 1;	// make sure something goes out
+    }
+}
+
+GammaEncode12::GammaEncode12(float value) : curve(new int16_t[size]) {
+    gamma(value);
+}
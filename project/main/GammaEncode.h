@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <memory>
 
 /// GammaEncode is a function object
 /// that is constructed with a gamma correction value
@@ -16,3 +17,22 @@ public:
     GammaEncode(float value);
     uint8_t operator()(uint8_t value) const {return curve[value];}
 };
+
+/// GammaEncode12 is like GammaEncode but for the 12 bit values
+/// rendered with int16_t (see APA102::LED<int16_t>).
+/// Values are clipped to [0, max] and non-zero values will not encode to 0.
+/// Its (8 KB) curve is allocated from the heap
+/// so that it does not burden the stack of its owner.
+class GammaEncode12 {
+public:
+    static int16_t constexpr max {0xfff};
+    static auto constexpr size = 1 + max;
+private:
+    std::unique_ptr<int16_t[]> const curve;
+public:
+    void gamma(float value);
+    GammaEncode12(float value);
+    int16_t operator()(int16_t value) const {
+	return 0 > value ? 0 : max < value ? max : curve[value];
+    }
+};
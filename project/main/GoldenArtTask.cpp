@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -8,6 +9,7 @@
 #include <vector>
 
 #include "esp_log.h"
+#include "esp_timer.h"
 extern "C" {
 #include "esp_time_impl.h"
 }
@@ -18,8 +20,8 @@ extern "C" {
 #include "Contrast.h"
 #include "GoldenArtTask.h"
 #include "Curve.h"
-#include "PerlinNoise.hpp"
-#include "Timer.h"
+#include "DialShape.h"
+#include "PerlinNoiseQ16.h"
 #include "TSL2591LuxSensor.h"
 
 constexpr float pi	{std::acos(-1.0f)};
@@ -41,10 +43,12 @@ constexpr unsigned millisecondsPerSecond	{1000u};
 constexpr unsigned microsecondsPerSecond	{1000000u};
 
 #define rimEnd 1024
-constexpr size_t ledCount {rimEnd};
+constexpr size_t GoldenArtTask::ledCount;
+constexpr size_t GoldenArtTask::rimSizeMax;
+static_assert(rimEnd == GoldenArtTask::ledCount, "rimEnd must be ledCount");
 
 char const * const GoldenArtTask::Mode::string[]
-    {"clock", "swirl", "solid"};
+    {"clock", "swirl", "solid", "playback", "stream"};
 GoldenArtTask::Mode::Mode(Value value_) : value(value_) {}
 GoldenArtTask::Mode::Mode(char const * value) : value(
     [value](){
@@ -61,41 +65,28 @@ char const * GoldenArtTask::Mode::toString() const {
 }
 
 namespace {
-// A Path may be used to construct a standard input iterator
-// that begins at an unsigned value,
-// decrements a unsigned step (default 1) as it is advanced
-// until it exhausts all unsigned values on this path.
-class Path {
-public:
-    class Iterator: public std::iterator<std::input_iterator_tag, unsigned,
-	unsigned, unsigned const *, unsigned> {
-    public:
-	explicit Iterator(Path const * path_)
-	    : path{path_}, value{path->value} {}
-	explicit Iterator()
-	    : path{nullptr}, value{std::numeric_limits<value_type>::max()} {}
-	Iterator & operator++() {
-	    if (path) {
-		if (value < path->step)
-		    value = std::numeric_limits<value_type>::max();
-		else
-		    value -= path->step;
-	    }
-	    return *this;
+/// A RimGather gathers the values rendered for the slots of a rim
+/// into the LEDs of its side (0 or 1) of it.
+/// Each side is half of the LEDs on the rim so that ForkJoin
+/// work on either does not touch the other.
+struct RimGather {
+    unsigned				end;
+    uint8_t const *			slot;
+    APA102::LED<int16_t> const *	values;
+
+    void add(APA102::LED<int16_t> * led, unsigned side) const {
+	auto const middle {end / 2};
+	for (auto l {side ? middle : 0u}; l < (side ? end : middle); ++l) {
+	    led[l] = led[l] + values[slot[l]];
 	}
-	bool operator==(Iterator that) const {return value == that.value;}
-	bool operator!=(Iterator that) const {return !(*this == that);}
-	reference operator*() const {return value;}
-    private:
-	Path const * path;
-	value_type value;
-    };
-    Path(Iterator::value_type value_, Iterator::value_type step_ = 1) : value{value_}, step{step_} {}
-    Iterator begin() {return Iterator(this);}
-    Iterator end() {return Iterator();}
-private:
-    Iterator::value_type const value;
-    Iterator::value_type const step;
+    }
+
+    void assign(APA102::LED<int16_t> * led, unsigned side) const {
+	auto const middle {end / 2};
+	for (auto l {side ? middle : 0u}; l < (side ? end : middle); ++l) {
+	    led[l] = values[slot[l]];
+	}
+    }
 };
 }
 
@@ -103,6 +94,62 @@ static constexpr float phaseIn(uint64_t time, uint64_t period) {
     return (time % period) / static_cast<float>(period);
 }
 
+namespace {
+/// A DialRender has what is needed to render a dial's rim into its values.
+/// An array of these is shared by both sides of ForkJoin,
+/// which render() alternating dials without any type erasure.
+struct DialRender {
+    DialPreferences::Shape::Value	shape;
+    unsigned				rimSize;
+    bool				flip;		///< HalfDial
+    unsigned				closest;
+    float				position;
+    float				width;
+    float				wavePhase;		///< wave
+    float				bloomPhase;		///< bloom
+    APA102::LED<int16_t>		faded;
+    APA102::LED<int16_t> *		values;
+
+    void render() const {
+	Blend<APA102::LED<int16_t>> const blend
+	    {APA102::LED<int16_t> {}, faded};
+	HalfDial const dial {position, flip};
+	BellCurve<> const bell {0.0f, width};
+	switch (shape) {
+	    case DialPreferences::Shape::Value::bell: {
+		renderRim(BellShape{dial, bell},
+		    blend, faded, rimSize, closest, values);
+	    } break;
+	    case DialPreferences::Shape::Value::wave: {
+		auto const waveWidth {2.0f / rimSize};
+		auto wavePosition {wavePhase * waveWidth};
+		if (1 & rimSize) {
+		    // for an odd rimSize, there is an ugly seam
+		    // where the wrap-around wave meets itself
+		    // because the sides will not be in phase.
+		    // we can hide this seam in the far half of
+		    // the dial by  shifting the wavePosition.
+		    // the shift must be an integral multiple
+		    // of waveWidth to preserve the wavePeriod.
+		    wavePosition += waveWidth * (0
+			+ (flip ? 1 : -1)
+			+ std::floor((position - 0.5f) / waveWidth));
+		}
+		WaveDial const wave {wavePosition, waveWidth};
+		renderRim(WaveShape{dial, bell, wave},
+		    blend, faded, rimSize, closest, values);
+	    } break;
+	    case DialPreferences::Shape::Value::bloom: {
+		BumpCurve const bump{0.0f, width};
+		BloomCurve const bloom{0.0f, width, bloomPhase};
+		renderRim(BloomShape{dial, bump, bloom},
+		    blend, faded, rimSize, closest, values);
+	    } break;
+	}
+    }
+};
+}
+
 static float fade_(float high, float dim, float min, float from) {
     if (1.0f <= from || 0.0f == dim || min > high) {
 	return high;		// snap high
@@ -116,275 +163,494 @@ static float fade_(float high, float dim, float min, float from) {
     }
 }
 
-void GoldenArtTask::update_() {
-    // LED i [0, ledCount) is rendered like a seed in a sunflower head
-    // at polar coordinate
-    //	(scale * sqrt(1 + i), i * tau / phi)
-    // where scale was chosen to space the LEDs adequately
-    // (18 mil for SK9822 5050 (5.0 x 5.0 mm) LEDs).
-    //
-    // such rendering creates a family of spirals for each fibonacci number N
-    // where
-    // * N is the number of spirals in the family and
-    // * N separates neighboring LEDs in any spiral.
-
-    // for rendering a family of spirals,
-    // it is convenient to have the outermost rim of indeces (from the end)
-    // of each ordered in a clockwise manner from the top.
-    // these were imported from exploratory rendering code.
-    // see easyeda/projects/golden/golden.html.
-
-    #define rimName_(end, index) rim##end##_##index
-    #define rimName(end, index) rimName_(end, index)
-    #define rimDecl(end, index) rimName_(end, index)[fibonacci(index)]
-
-    struct Rim {
-	unsigned const	end;
-	unsigned const	fibonacciIndex;
-	uint8_t const *	sequence;
-    };
-    #define RimArgs(end, index) {end, index, rimName(end, index)}
+namespace {
+// LED i [0, ledCount) is rendered like a seed in a sunflower head
+// at polar coordinate
+//	(scale * sqrt(1 + i), i * tau / phi)
+// where scale was chosen to space the LEDs adequately
+// (18 mil for SK9822 5050 (5.0 x 5.0 mm) LEDs).
+//
+// such rendering creates a family of spirals for each fibonacci number N
+// where
+// * N is the number of spirals in the family and
+// * N separates neighboring LEDs in any spiral.
+
+// for rendering a family of spirals,
+// it is convenient to have the outermost rim of indeces (from the end)
+// of each ordered in a clockwise manner from the top.
+// these were imported from exploratory rendering code.
+// see easyeda/projects/golden/golden.html.
+
+#define rimName_(end, index) rim##end##_##index
+#define rimName(end, index) rimName_(end, index)
+#define rimDecl(end, index) rimName_(end, index)[fibonacci(index)]
+
+struct Rim {
+    unsigned const	end;
+    unsigned const	fibonacciIndex;
+    uint8_t const *	sequence;
+    uint8_t const *	slot;		///< Gather<end, index, sequence>::slot
+};
 
-    static constexpr uint8_t rimDecl(rimEnd, 7) {
-	0,  5, 10,  2,  7, 12,  4,  9,  1,  6, 11,  3,  8,
-    };
-    static constexpr uint8_t rimDecl(917, 7) {
-	 3,  8,  0,  5, 10,  2,  7, 12,  4,  9,  1,  6, 11,
-    };
-    static constexpr uint8_t rimDecl(569, 7) {
-	11,  3,  8,  0,  5, 10,  2,  7, 12,  4,  9,  1,  6,
-    };
-    static constexpr uint8_t rimDecl(355, 7) {
-	 9,  1,  6, 11,  3,  8,  0,  5, 10,  2,  7, 12,  4,
-    };
-    static constexpr uint8_t rimDecl(233, 7) {
-	 5, 10,  2,  7, 12,  4,  9,  1,  6, 11,  3,  8,  0,
-    };
-    static constexpr uint8_t rimDecl(145, 7) {
-	 6, 11,  3,  8,  0,  5, 10,  2,  7, 12,  4,  9,  1,
-    };
-    static constexpr uint8_t rimDecl( 91, 7) {
-	12,  4,  9,  1,  6, 11,  3,  8,  0,  5, 10,  2,  7,
-    };
-    static constexpr uint8_t rimDecl( 57, 7) {
-	 7, 12,  4,  9,  1,  6, 11,  3,  8,  0,  5, 10,  2,
-    };
-    static constexpr Rim const rim7[] {
-	RimArgs(rimEnd, 7),
-	RimArgs(917, 7),
-	RimArgs(569, 7),
-	RimArgs(355, 7),
-	RimArgs(233, 7),
-	RimArgs(145, 7),
-	RimArgs( 91, 7),
-	RimArgs( 57, 7),
-    };
+// each LED l in [0, end) of a rim is on the spiral that ends
+// at the rim index end - 1 - k (k = (end - 1 - l) % fibonacci(index)),
+// which is in the sequence at the rim slot j (sequence[j] == k).
+// a Gather table maps each l to its slot j
+// so that values rendered for each slot can be gathered
+// by LEDs in one contiguous pass.
+// these are generated at compile time and stored in flash
+// (one byte per LED, for a total of sum(end) bytes. see rimGatherSize).
+
+template <unsigned... i> struct Indices {};
+
+// concatenate Indices<0, ... a - 1> and Indices<0, ... b - 1>
+// to Indices<0, ... a + b - 1>
+template <typename, typename> struct IndicesConcat;
+template <unsigned... a, unsigned... b>
+struct IndicesConcat<Indices<a...>, Indices<b...>> {
+    using Type = Indices<a..., (sizeof...(a) + b)...>;
+};
 
-    static constexpr uint8_t rimDecl(rimEnd, 8) {
-	 0, 13,  5, 18, 10,  2, 15,  7, 20, 12,  4, 17,  9,  1, 14,  6,
-	19, 11,  3, 16,  8,
-    };
-    static constexpr uint8_t rimDecl(917, 8) {
-	 3, 16,  8,  0, 13,  5, 18, 10,  2, 15,  7, 20, 12,  4, 17,  9,
-	 1, 14,  6, 19, 11,
-    };
-    static constexpr uint8_t rimDecl(582, 8) {
-	 3, 16,  8,  0, 13,  5, 18, 10,  2, 15,  7, 20, 12,  4, 17,  9,
-	 1, 14,  6, 19, 11,
-    };
-    static constexpr uint8_t rimDecl(361, 8) {
-	 2, 15,  7, 20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,  8,
-	 0, 13,  5, 18, 10,
-    };
-    static constexpr uint8_t rimDecl(225, 8) {
-	10,  2, 15,  7, 20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,
-	 8,  0, 13,  5, 18,
-    };
-    static constexpr uint8_t rimDecl(141, 8) {
-	15,  7, 20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,  8,  0,
-	13,  5, 18, 10,  2,
-    };
-    static constexpr uint8_t rimDecl( 91, 8) {
-	20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,  8,  0, 13,  5,
-	18, 10,  2, 15,  7,
-    };
-    static constexpr Rim const rim8[] {
-	RimArgs(rimEnd, 8),
-	RimArgs(917, 8),
-	RimArgs(582, 8),
-	RimArgs(361, 8),
-	RimArgs(225, 8),
-	RimArgs(141, 8),
-	RimArgs( 91, 8),
-    };
+// make Indices<0, ... n - 1> with a template recursion depth of log2(n)
+template <unsigned n> struct MakeIndices {
+    using Type = typename IndicesConcat<
+	typename MakeIndices<n / 2>::Type,
+	typename MakeIndices<n - n / 2>::Type>::Type;
+};
+template <> struct MakeIndices<0> {using Type = Indices<>;};
+template <> struct MakeIndices<1> {using Type = Indices<0>;};
 
-    static constexpr uint8_t rimDecl(rimEnd, 9) {
-	 0, 13, 26,  5, 18, 31, 10, 23,  2, 15, 28,  7, 20, 33, 12, 25,
-	 4, 17, 30,  9, 22,  1, 14, 27,  6, 19, 32, 11, 24,  3, 16, 29,
-	 8, 21,
-    };
-    static constexpr uint8_t rimDecl(917, 9) {
-	 3, 16, 29,  8, 21,  0, 13, 26,  5, 18, 31, 10, 23,  2, 15, 28,
-	 7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1, 14, 27,  6, 19, 32,
-	11, 24,
-    };
-    static constexpr uint8_t rimDecl(569, 9) {
-	11, 24,  3, 16, 29,  8, 21,  0, 13, 26,  5, 18, 31, 10, 23,  2,
-	15, 28,  7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1, 14, 27,  6,
-	19, 32,
-    };
-    static constexpr uint8_t rimDecl(355, 9) {
-	30,  9, 22,  1, 14, 27,  6, 19, 32, 11, 24,  3, 16, 29,  8, 21,
-	 0, 13, 26,  5, 18, 31, 10, 23,  2, 15, 28,  7, 20, 33, 12, 25,
-	 4, 17,
-    };
-    static constexpr uint8_t rimDecl(225, 9) {
-	10, 23,  2, 15, 28,  7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1,
-	14, 27,  6, 19, 32, 11, 24,  3, 16, 29,  8, 21,  0, 13, 26,  5,
-	18, 31,
-    };
-    static constexpr uint8_t rimDecl(141, 9) {
-	15, 28,  7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1, 14, 27,  6,
-	19, 32, 11, 24,  3, 16, 29,  8, 21,  0, 13, 26,  5, 18, 31, 10,
-	23, 2,
-    };
-    static constexpr Rim const rim9[] {
-	RimArgs(rimEnd, 9),
-	RimArgs(917, 9),
-	RimArgs(569, 9),
-	RimArgs(355, 9),
-	RimArgs(225, 9),
-	RimArgs(141, 9),
-    };
+static constexpr uint8_t slotOf(uint8_t const * sequence, unsigned k, unsigned j = 0) {
+    return k == sequence[j] ? j : slotOf(sequence, k, j + 1);
+}
 
-    static constexpr uint8_t rimDecl(rimEnd, 10) {
-	 0, 34, 13, 47, 26,  5, 39, 18, 52, 31, 10, 44, 23,  2, 36, 15,
-	49, 28,  7, 41, 20, 54, 33, 12, 46, 25,  4, 38, 17, 51, 30,  9,
-	43, 22,  1, 35, 14, 48, 27,  6, 40, 19, 53, 32, 11, 45, 24,  3,
-	37, 16, 50, 29,  8, 42, 21,
-    };
-    static constexpr uint8_t rimDecl(907, 10) {
-	27,  6, 40, 19, 53, 32, 11, 45, 24,  3, 37, 16, 50, 29,  8, 42,
-	21,  0, 34, 13, 47, 26,  5, 39, 18, 52, 31, 10, 44, 23,  2, 36,
-	15, 49, 28,  7, 41, 20, 54, 33, 12, 46, 25,  4, 38, 17, 51, 30,
-	 9, 43, 22,  1, 35, 14, 48,
-    };
-    static constexpr uint8_t rimDecl(582, 10) {
-	24,  3, 37, 16, 50, 29,  8, 42, 21,  0, 34, 13, 47, 26,  5, 39,
-	18, 52, 31, 10, 44, 23,  2, 36, 15, 49, 28,  7, 41, 20, 54, 33,
-	12, 46, 25,  4, 38, 17, 51, 30,  9, 43, 22,  1, 35, 14, 48, 27,
-	 6, 40, 19, 53, 32, 11, 45,
-    };
-    static constexpr uint8_t rimDecl(355, 10) {
-	30,  9, 43, 22,  1, 35, 14, 48, 27,  6, 40, 19, 53, 32, 11, 45,
-	24,  3, 37, 16, 50, 29,  8, 42, 21,  0, 34, 13, 47, 26,  5, 39,
-	18, 52, 31, 10, 44, 23,  2, 36, 15, 49, 28,  7, 41, 20, 54, 33,
-	12, 46, 25,  4, 38, 17, 51,
-    };
-    static constexpr uint8_t rimDecl(225, 10) {
-	44, 23,  2, 36, 15, 49, 28,  7, 41, 20, 54, 33, 12, 46, 25,  4,
-	38, 17, 51, 30,  9, 43, 22,  1, 35, 14, 48, 27,  6, 40, 19, 53,
-	32, 11, 45, 24,  3, 37, 16, 50, 29,  8, 42, 21,  0, 34, 13, 47,
-	26,  5, 39, 18, 52, 31, 10,
-    };
-    static constexpr Rim const rim10[] {
-	RimArgs(rimEnd, 10),
-	RimArgs(907, 10),
-	RimArgs(582, 10),
-	RimArgs(355, 10),
-	RimArgs(225, 10),
+template <unsigned end, unsigned index, uint8_t const * sequence,
+    typename = typename MakeIndices<end>::Type>
+struct Gather;
+template <unsigned end, unsigned index, uint8_t const * sequence, unsigned... l>
+struct Gather<end, index, sequence, Indices<l...>> {
+    static constexpr uint8_t slot[end] {
+	slotOf(sequence, (end - 1 - l) % fibonacci(index))...
     };
+};
+template <unsigned end, unsigned index, uint8_t const * sequence, unsigned... l>
+constexpr uint8_t Gather<end, index, sequence, Indices<l...>>::slot[end];
 
-    static constexpr uint8_t rimDecl(rimEnd, 11) {
-	 0, 34, 68, 13, 47, 81, 26, 60,  5, 39, 73, 18, 52, 86, 31, 65,
-	10, 44, 78, 23, 57,  2, 36, 70, 15, 49, 83, 28, 62,  7, 41, 75,
-	20, 54, 88, 33, 67, 12, 46, 80, 25, 59,  4, 38, 72, 17, 51, 85,
-	30, 64,  9, 43, 77, 22, 56,  1, 35, 69, 14, 48, 82, 27, 61,  6,
-	40, 74, 19, 53, 87, 32, 66, 11, 45, 79, 24, 58,  3, 37, 71, 16,
-	50, 84, 29, 63,  8, 42, 76, 21, 55,
-    };
-    static constexpr uint8_t rimDecl(907, 11) {
-	27, 61,  6, 40, 74, 19, 53, 87, 32, 66, 11, 45, 79, 24, 58,  3,
-	37, 71, 16, 50, 84, 29, 63,  8, 42, 76, 21, 55,  0, 34, 68, 13,
-	47, 81, 26, 60,  5, 39, 73, 18, 52, 86, 31, 65, 10, 44, 78, 23,
-	57,  2, 36, 70, 15, 49, 83, 28, 62,  7, 41, 75, 20, 54, 88, 33,
-	67, 12, 46, 80, 25, 59,  4, 38, 72, 17, 51, 85, 30, 64,  9, 43,
-	77, 22, 56,  1, 35, 69, 14, 48, 82,
-    };
-    static constexpr uint8_t rimDecl(569, 11) {
-	66, 11, 45, 79, 24, 58,  3, 37, 71, 16, 50, 84, 29, 63,  8, 42,
-	76, 21, 55,  0, 34, 68, 13, 47, 81, 26, 60,  5, 39, 73, 18, 52,
-	86, 31, 65, 10, 44, 78, 23, 57,  2, 36, 70, 15, 49, 83, 28, 62,
-	 7, 41, 75, 20, 54, 88, 33, 67, 12, 46, 80, 25, 59,  4, 38, 72,
-	17, 51, 85, 30, 64,  9, 43, 77, 22, 56,  1, 35, 69, 14, 48, 82,
-	27, 61,  6, 40, 74, 19, 53, 87, 32,
-    };
-    static constexpr uint8_t rimDecl(361, 11) {
-	 2, 36, 70, 15, 49, 83, 28, 62,  7, 41, 75, 20, 54, 88, 33, 67,
-	12, 46, 80, 25, 59,  4, 38, 72, 17, 51, 85, 30, 64,  9, 43, 77,
-	22, 56,  1, 35, 69, 14, 48, 82, 27, 61,  6, 40, 74, 19, 53, 87,
-	32, 66, 11, 45, 79, 24, 58,  3, 37, 71, 16, 50, 84, 29, 63,  8,
-	42, 76, 21, 55,  0, 34, 68, 13, 47, 81, 26, 60,  5, 39, 73, 18,
-	52, 86, 31, 65, 10, 44, 78, 23, 57,
-    };
-    static constexpr Rim const rim11[] {
-	RimArgs(rimEnd, 11),
-	RimArgs(907, 11),
-	RimArgs(569, 11),
-	RimArgs(361, 11),
-    };
+#define RimArgs(end, index) {end, index, rimName(end, index), \
+    Gather<end, index, rimName(end, index)>::slot}
 
-    static constexpr uint8_t rimDecl(rimEnd, 12) {
-	  0,  89,  34, 123,  68,  13, 102,  47, 136,  81,  26, 115,  60,   5,  94,  39,
-	128,  73,  18, 107,  52, 141,  86,  31, 120,  65,  10,  99,  44, 133,  78,  23,
-	112,  57,   2,  91,  36, 125,  70,  15, 104,  49, 138,  83,  28, 117,  62,   7,
-	 96,  41, 130,  75,  20, 109,  54, 143,  88,  33, 122,  67,  12, 101,  46, 135,
-	 80,  25, 114,  59,   4,  93,  38, 127,  72,  17, 106,  51, 140,  85,  30, 119,
-	 64,   9,  98,  43, 132,  77,  22, 111,  56,   1,  90,  35, 124,  69,  14, 103,
-	 48, 137,  82,  27, 116,  61,   6,  95,  40, 129,  74,  19, 108,  53, 142,  87,
-	 32, 121,  66,  11, 100,  45, 134,  79,  24, 113,  58,   3,  92,  37, 126,  71,
-	 16, 105,  50, 139,  84,  29, 118,  63,   8,  97,  42, 131,  76,  21, 110,  55,
-    };
-    static constexpr uint8_t rimDecl(917, 12) {
-	 37, 126,  71,  16, 105,  50, 139,  84,  29, 118,  63,   8,  97,  42, 131,  76,
-	 21, 110,  55,   0,  89,  34, 123,  68,  13, 102,  47, 136,  81,  26, 115,  60,
-	  5,  94,  39, 128,  73,  18, 107,  52, 141,  86,  31, 120,  65,  10,  99,  44,
-	133,  78,  23, 112,  57,   2,  91,  36, 125,  70,  15, 104,  49, 138,  83,  28,
-	117,  62,   7,  96,  41, 130,  75,  20, 109,  54, 143,  88,  33, 122,  67,  12,
-	101,  46, 135,  80,  25, 114,  59,   4,  93,  38, 127,  72,  17, 106,  51, 140,
-	 85,  30, 119,  64,   9,  98,  43, 132,  77,  22, 111,  56,   1,  90,  35, 124,
-	 69,  14, 103,  48, 137,  82,  27, 116,  61,   6,  95,  40, 129,  74,  19, 108,
-	 53, 142,  87,  32, 121,  66,  11, 100,  45, 134,  79,  24, 113,  58,   3,  92,
-    };
-    static constexpr uint8_t rimDecl(582, 12) {
-	 79,  24, 113,  58,   3,  92,  37, 126,  71,  16, 105,  50, 139,  84,  29, 118,
-	 63,   8,  97,  42, 131,  76,  21, 110,  55,   0,  89,  34, 123,  68,  13, 102,
-	 47, 136,  81,  26, 115,  60,   5,  94,  39, 128,  73,  18, 107,  52, 141,  86,
-	 31, 120,  65,  10,  99,  44, 133,  78,  23, 112,  57,   2,  91,  36, 125,  70,
-	 15, 104,  49, 138,  83,  28, 117,  62,   7,  96,  41, 130,  75,  20, 109,  54,
-	143,  88,  33, 122,  67,  12, 101,  46, 135,  80,  25, 114,  59,   4,  93,  38,
-	127,  72,  17, 106,  51, 140,  85,  30, 119,  64,   9,  98,  43, 132,  77,  22,
-	111,  56,   1,  90,  35, 124,  69,  14, 103,  48, 137,  82,  27, 116,  61,   6,
-	 95,  40, 129,  74,  19, 108,  53, 142,  87,  32, 121,  66,  11, 100,  45, 134,
-    };
-    static constexpr Rim const rim12[] {
-	RimArgs(rimEnd, 12),
-	RimArgs(917, 12),
-	RimArgs(582, 12),
-    };
+constexpr uint8_t rimDecl(rimEnd, 7) {
+    0,  5, 10,  2,  7, 12,  4,  9,  1,  6, 11,  3,  8,
+};
+constexpr uint8_t rimDecl(917, 7) {
+     3,  8,  0,  5, 10,  2,  7, 12,  4,  9,  1,  6, 11,
+};
+constexpr uint8_t rimDecl(569, 7) {
+    11,  3,  8,  0,  5, 10,  2,  7, 12,  4,  9,  1,  6,
+};
+constexpr uint8_t rimDecl(355, 7) {
+     9,  1,  6, 11,  3,  8,  0,  5, 10,  2,  7, 12,  4,
+};
+constexpr uint8_t rimDecl(233, 7) {
+     5, 10,  2,  7, 12,  4,  9,  1,  6, 11,  3,  8,  0,
+};
+constexpr uint8_t rimDecl(145, 7) {
+     6, 11,  3,  8,  0,  5, 10,  2,  7, 12,  4,  9,  1,
+};
+constexpr uint8_t rimDecl( 91, 7) {
+    12,  4,  9,  1,  6, 11,  3,  8,  0,  5, 10,  2,  7,
+};
+constexpr uint8_t rimDecl( 57, 7) {
+     7, 12,  4,  9,  1,  6, 11,  3,  8,  0,  5, 10,  2,
+};
+constexpr Rim const rim7[] {
+    RimArgs(rimEnd, 7),
+    RimArgs(917, 7),
+    RimArgs(569, 7),
+    RimArgs(355, 7),
+    RimArgs(233, 7),
+    RimArgs(145, 7),
+    RimArgs( 91, 7),
+    RimArgs( 57, 7),
+};
 
-    static constexpr Array<Rim const> rim[] {
-	rim12,
-	rim11,
-	rim10,
-	rim9,
-	rim8,
-	rim7,
-    };
+constexpr uint8_t rimDecl(rimEnd, 8) {
+     0, 13,  5, 18, 10,  2, 15,  7, 20, 12,  4, 17,  9,  1, 14,  6,
+    19, 11,  3, 16,  8,
+};
+constexpr uint8_t rimDecl(917, 8) {
+     3, 16,  8,  0, 13,  5, 18, 10,  2, 15,  7, 20, 12,  4, 17,  9,
+     1, 14,  6, 19, 11,
+};
+constexpr uint8_t rimDecl(582, 8) {
+     3, 16,  8,  0, 13,  5, 18, 10,  2, 15,  7, 20, 12,  4, 17,  9,
+     1, 14,  6, 19, 11,
+};
+constexpr uint8_t rimDecl(361, 8) {
+     2, 15,  7, 20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,  8,
+     0, 13,  5, 18, 10,
+};
+constexpr uint8_t rimDecl(225, 8) {
+    10,  2, 15,  7, 20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,
+     8,  0, 13,  5, 18,
+};
+constexpr uint8_t rimDecl(141, 8) {
+    15,  7, 20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,  8,  0,
+    13,  5, 18, 10,  2,
+};
+constexpr uint8_t rimDecl( 91, 8) {
+    20, 12,  4, 17,  9,  1, 14,  6, 19, 11,  3, 16,  8,  0, 13,  5,
+    18, 10,  2, 15,  7,
+};
+constexpr Rim const rim8[] {
+    RimArgs(rimEnd, 8),
+    RimArgs(917, 8),
+    RimArgs(582, 8),
+    RimArgs(361, 8),
+    RimArgs(225, 8),
+    RimArgs(141, 8),
+    RimArgs( 91, 8),
+};
+
+constexpr uint8_t rimDecl(rimEnd, 9) {
+     0, 13, 26,  5, 18, 31, 10, 23,  2, 15, 28,  7, 20, 33, 12, 25,
+     4, 17, 30,  9, 22,  1, 14, 27,  6, 19, 32, 11, 24,  3, 16, 29,
+     8, 21,
+};
+constexpr uint8_t rimDecl(917, 9) {
+     3, 16, 29,  8, 21,  0, 13, 26,  5, 18, 31, 10, 23,  2, 15, 28,
+     7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1, 14, 27,  6, 19, 32,
+    11, 24,
+};
+constexpr uint8_t rimDecl(569, 9) {
+    11, 24,  3, 16, 29,  8, 21,  0, 13, 26,  5, 18, 31, 10, 23,  2,
+    15, 28,  7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1, 14, 27,  6,
+    19, 32,
+};
+constexpr uint8_t rimDecl(355, 9) {
+    30,  9, 22,  1, 14, 27,  6, 19, 32, 11, 24,  3, 16, 29,  8, 21,
+     0, 13, 26,  5, 18, 31, 10, 23,  2, 15, 28,  7, 20, 33, 12, 25,
+     4, 17,
+};
+constexpr uint8_t rimDecl(225, 9) {
+    10, 23,  2, 15, 28,  7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1,
+    14, 27,  6, 19, 32, 11, 24,  3, 16, 29,  8, 21,  0, 13, 26,  5,
+    18, 31,
+};
+constexpr uint8_t rimDecl(141, 9) {
+    15, 28,  7, 20, 33, 12, 25,  4, 17, 30,  9, 22,  1, 14, 27,  6,
+    19, 32, 11, 24,  3, 16, 29,  8, 21,  0, 13, 26,  5, 18, 31, 10,
+    23, 2,
+};
+constexpr Rim const rim9[] {
+    RimArgs(rimEnd, 9),
+    RimArgs(917, 9),
+    RimArgs(569, 9),
+    RimArgs(355, 9),
+    RimArgs(225, 9),
+    RimArgs(141, 9),
+};
+
+constexpr uint8_t rimDecl(rimEnd, 10) {
+     0, 34, 13, 47, 26,  5, 39, 18, 52, 31, 10, 44, 23,  2, 36, 15,
+    49, 28,  7, 41, 20, 54, 33, 12, 46, 25,  4, 38, 17, 51, 30,  9,
+    43, 22,  1, 35, 14, 48, 27,  6, 40, 19, 53, 32, 11, 45, 24,  3,
+    37, 16, 50, 29,  8, 42, 21,
+};
+constexpr uint8_t rimDecl(907, 10) {
+    27,  6, 40, 19, 53, 32, 11, 45, 24,  3, 37, 16, 50, 29,  8, 42,
+    21,  0, 34, 13, 47, 26,  5, 39, 18, 52, 31, 10, 44, 23,  2, 36,
+    15, 49, 28,  7, 41, 20, 54, 33, 12, 46, 25,  4, 38, 17, 51, 30,
+     9, 43, 22,  1, 35, 14, 48,
+};
+constexpr uint8_t rimDecl(582, 10) {
+    24,  3, 37, 16, 50, 29,  8, 42, 21,  0, 34, 13, 47, 26,  5, 39,
+    18, 52, 31, 10, 44, 23,  2, 36, 15, 49, 28,  7, 41, 20, 54, 33,
+    12, 46, 25,  4, 38, 17, 51, 30,  9, 43, 22,  1, 35, 14, 48, 27,
+     6, 40, 19, 53, 32, 11, 45,
+};
+constexpr uint8_t rimDecl(355, 10) {
+    30,  9, 43, 22,  1, 35, 14, 48, 27,  6, 40, 19, 53, 32, 11, 45,
+    24,  3, 37, 16, 50, 29,  8, 42, 21,  0, 34, 13, 47, 26,  5, 39,
+    18, 52, 31, 10, 44, 23,  2, 36, 15, 49, 28,  7, 41, 20, 54, 33,
+    12, 46, 25,  4, 38, 17, 51,
+};
+constexpr uint8_t rimDecl(225, 10) {
+    44, 23,  2, 36, 15, 49, 28,  7, 41, 20, 54, 33, 12, 46, 25,  4,
+    38, 17, 51, 30,  9, 43, 22,  1, 35, 14, 48, 27,  6, 40, 19, 53,
+    32, 11, 45, 24,  3, 37, 16, 50, 29,  8, 42, 21,  0, 34, 13, 47,
+    26,  5, 39, 18, 52, 31, 10,
+};
+constexpr Rim const rim10[] {
+    RimArgs(rimEnd, 10),
+    RimArgs(907, 10),
+    RimArgs(582, 10),
+    RimArgs(355, 10),
+    RimArgs(225, 10),
+};
 
-    // construct static PerlinNoise objects
+constexpr uint8_t rimDecl(rimEnd, 11) {
+     0, 34, 68, 13, 47, 81, 26, 60,  5, 39, 73, 18, 52, 86, 31, 65,
+    10, 44, 78, 23, 57,  2, 36, 70, 15, 49, 83, 28, 62,  7, 41, 75,
+    20, 54, 88, 33, 67, 12, 46, 80, 25, 59,  4, 38, 72, 17, 51, 85,
+    30, 64,  9, 43, 77, 22, 56,  1, 35, 69, 14, 48, 82, 27, 61,  6,
+    40, 74, 19, 53, 87, 32, 66, 11, 45, 79, 24, 58,  3, 37, 71, 16,
+    50, 84, 29, 63,  8, 42, 76, 21, 55,
+};
+constexpr uint8_t rimDecl(907, 11) {
+    27, 61,  6, 40, 74, 19, 53, 87, 32, 66, 11, 45, 79, 24, 58,  3,
+    37, 71, 16, 50, 84, 29, 63,  8, 42, 76, 21, 55,  0, 34, 68, 13,
+    47, 81, 26, 60,  5, 39, 73, 18, 52, 86, 31, 65, 10, 44, 78, 23,
+    57,  2, 36, 70, 15, 49, 83, 28, 62,  7, 41, 75, 20, 54, 88, 33,
+    67, 12, 46, 80, 25, 59,  4, 38, 72, 17, 51, 85, 30, 64,  9, 43,
+    77, 22, 56,  1, 35, 69, 14, 48, 82,
+};
+constexpr uint8_t rimDecl(569, 11) {
+    66, 11, 45, 79, 24, 58,  3, 37, 71, 16, 50, 84, 29, 63,  8, 42,
+    76, 21, 55,  0, 34, 68, 13, 47, 81, 26, 60,  5, 39, 73, 18, 52,
+    86, 31, 65, 10, 44, 78, 23, 57,  2, 36, 70, 15, 49, 83, 28, 62,
+     7, 41, 75, 20, 54, 88, 33, 67, 12, 46, 80, 25, 59,  4, 38, 72,
+    17, 51, 85, 30, 64,  9, 43, 77, 22, 56,  1, 35, 69, 14, 48, 82,
+    27, 61,  6, 40, 74, 19, 53, 87, 32,
+};
+constexpr uint8_t rimDecl(361, 11) {
+     2, 36, 70, 15, 49, 83, 28, 62,  7, 41, 75, 20, 54, 88, 33, 67,
+    12, 46, 80, 25, 59,  4, 38, 72, 17, 51, 85, 30, 64,  9, 43, 77,
+    22, 56,  1, 35, 69, 14, 48, 82, 27, 61,  6, 40, 74, 19, 53, 87,
+    32, 66, 11, 45, 79, 24, 58,  3, 37, 71, 16, 50, 84, 29, 63,  8,
+    42, 76, 21, 55,  0, 34, 68, 13, 47, 81, 26, 60,  5, 39, 73, 18,
+    52, 86, 31, 65, 10, 44, 78, 23, 57,
+};
+constexpr Rim const rim11[] {
+    RimArgs(rimEnd, 11),
+    RimArgs(907, 11),
+    RimArgs(569, 11),
+    RimArgs(361, 11),
+};
+
+constexpr uint8_t rimDecl(rimEnd, 12) {
+      0,  89,  34, 123,  68,  13, 102,  47, 136,  81,  26, 115,  60,   5,  94,  39,
+    128,  73,  18, 107,  52, 141,  86,  31, 120,  65,  10,  99,  44, 133,  78,  23,
+    112,  57,   2,  91,  36, 125,  70,  15, 104,  49, 138,  83,  28, 117,  62,   7,
+     96,  41, 130,  75,  20, 109,  54, 143,  88,  33, 122,  67,  12, 101,  46, 135,
+     80,  25, 114,  59,   4,  93,  38, 127,  72,  17, 106,  51, 140,  85,  30, 119,
+     64,   9,  98,  43, 132,  77,  22, 111,  56,   1,  90,  35, 124,  69,  14, 103,
+     48, 137,  82,  27, 116,  61,   6,  95,  40, 129,  74,  19, 108,  53, 142,  87,
+     32, 121,  66,  11, 100,  45, 134,  79,  24, 113,  58,   3,  92,  37, 126,  71,
+     16, 105,  50, 139,  84,  29, 118,  63,   8,  97,  42, 131,  76,  21, 110,  55,
+};
+constexpr uint8_t rimDecl(917, 12) {
+     37, 126,  71,  16, 105,  50, 139,  84,  29, 118,  63,   8,  97,  42, 131,  76,
+     21, 110,  55,   0,  89,  34, 123,  68,  13, 102,  47, 136,  81,  26, 115,  60,
+      5,  94,  39, 128,  73,  18, 107,  52, 141,  86,  31, 120,  65,  10,  99,  44,
+    133,  78,  23, 112,  57,   2,  91,  36, 125,  70,  15, 104,  49, 138,  83,  28,
+    117,  62,   7,  96,  41, 130,  75,  20, 109,  54, 143,  88,  33, 122,  67,  12,
+    101,  46, 135,  80,  25, 114,  59,   4,  93,  38, 127,  72,  17, 106,  51, 140,
+     85,  30, 119,  64,   9,  98,  43, 132,  77,  22, 111,  56,   1,  90,  35, 124,
+     69,  14, 103,  48, 137,  82,  27, 116,  61,   6,  95,  40, 129,  74,  19, 108,
+     53, 142,  87,  32, 121,  66,  11, 100,  45, 134,  79,  24, 113,  58,   3,  92,
+};
+constexpr uint8_t rimDecl(582, 12) {
+     79,  24, 113,  58,   3,  92,  37, 126,  71,  16, 105,  50, 139,  84,  29, 118,
+     63,   8,  97,  42, 131,  76,  21, 110,  55,   0,  89,  34, 123,  68,  13, 102,
+     47, 136,  81,  26, 115,  60,   5,  94,  39, 128,  73,  18, 107,  52, 141,  86,
+     31, 120,  65,  10,  99,  44, 133,  78,  23, 112,  57,   2,  91,  36, 125,  70,
+     15, 104,  49, 138,  83,  28, 117,  62,   7,  96,  41, 130,  75,  20, 109,  54,
+    143,  88,  33, 122,  67,  12, 101,  46, 135,  80,  25, 114,  59,   4,  93,  38,
+    127,  72,  17, 106,  51, 140,  85,  30, 119,  64,   9,  98,  43, 132,  77,  22,
+    111,  56,   1,  90,  35, 124,  69,  14, 103,  48, 137,  82,  27, 116,  61,   6,
+     95,  40, 129,  74,  19, 108,  53, 142,  87,  32, 121,  66,  11, 100,  45, 134,
+};
+constexpr Rim const rim12[] {
+    RimArgs(rimEnd, 12),
+    RimArgs(917, 12),
+    RimArgs(582, 12),
+};
+
+constexpr Array<Rim const> rim[] {
+    rim12,
+    rim11,
+    rim10,
+    rim9,
+    rim8,
+    rim7,
+};
+
+static_assert(fibonacci(12) == GoldenArtTask::rimSizeMax,
+    "rimSizeMax must be the most places rendered on any rim");
+
+size_t rimGatherSize() {
+    size_t size {0};
+    for (auto const & rim_: rim) {
+	for (auto const * r {rim_.data}; r < rim_.data + rim_.size; ++r) {
+	    size += r->end;
+	}
+    }
+    return size;
+}
+}
+
+asio::io_context & GoldenArtTask::transmitIo() {
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    return transmitTask.io;
+#else
+    return io;
+#endif
+}
+
+// the natural rendering indeces need to be mapped to the path indeces
+// that reflect the way the LEDs are actually wired (addressed).
+// this order is conducive for board/trace layout.
+// see easyeda/projects/golden/scripts/goldenPath.js
+static constexpr uint16_t layout[GoldenArtTask::ledCount] {
+       0,    4,    8,    2,    6,    9,    3,    7,    1,    5,   22,   13,   18,   10,   15,   20,
+      12,   17,   23,   14,   19,   11,   16,   21,   29,   38,   24,   33,   42,   27,   36,   45,
+      31,   40,   25,   34,   43,   28,   37,   47,   32,   41,   26,   35,   44,   30,   39,   49,
+      61,   73,   54,   66,   46,   58,   70,   51,   63,   75,   56,   68,   48,   60,   72,   53,
+      65,   77,   57,   69,   50,   62,   74,   55,   67,   79,   59,   71,   52,   64,   76,   89,
+     102,   81,   94,  107,   86,   99,   78,   91,  104,   83,   96,  109,   88,  101,   80,   93,
+     106,   85,   98,  111,   90,  103,   82,   95,  108,   87,  100,  114,   92,  105,   84,   97,
+     110,  130,  151,  117,  138,  159,  125,  146,  112,  133,  154,  120,  141,  162,  128,  149,
+     115,  136,  157,  123,  144,  165,  131,  152,  118,  139,  160,  126,  147,  113,  134,  155,
+     121,  142,  163,  129,  150,  116,  137,  158,  124,  145,  166,  132,  153,  119,  140,  161,
+     127,  148,  169,  135,  156,  122,  143,  164,  185,  206,  172,  193,  214,  180,  201,  167,
+     188,  209,  175,  196,  217,  183,  204,  170,  191,  212,  178,  199,  220,  186,  207,  173,
+     194,  215,  181,  202,  168,  189,  210,  176,  197,  218,  184,  205,  171,  192,  213,  179,
+     200,  221,  187,  208,  174,  195,  216,  182,  203,  224,  190,  211,  177,  198,  219,  240,
+     261,  227,  248,  269,  235,  256,  222,  243,  264,  230,  251,  272,  238,  259,  225,  246,
+     267,  233,  254,  275,  241,  262,  228,  249,  270,  236,  257,  223,  244,  265,  231,  252,
+     273,  239,  260,  226,  247,  268,  234,  255,  276,  242,  263,  229,  250,  271,  237,  258,
+     279,  245,  266,  232,  253,  274,  296,  317,  283,  304,  325,  291,  312,  277,  299,  320,
+     286,  307,  328,  294,  315,  281,  302,  323,  289,  310,  331,  297,  318,  284,  305,  326,
+     292,  313,  278,  300,  321,  287,  308,  329,  295,  316,  282,  303,  324,  290,  311,  333,
+     298,  319,  285,  306,  327,  293,  314,  280,  301,  322,  288,  309,  330,  353,  374,  340,
+     361,  382,  348,  369,  335,  356,  377,  343,  364,  385,  351,  372,  338,  359,  380,  346,
+     367,  332,  354,  375,  341,  362,  383,  349,  370,  336,  357,  378,  344,  365,  387,  352,
+     373,  339,  360,  381,  347,  368,  334,  355,  376,  342,  363,  384,  350,  371,  337,  358,
+     379,  345,  366,  389,  415,  441,  399,  425,  451,  409,  435,  393,  419,  445,  403,  429,
+     386,  413,  439,  397,  423,  449,  407,  433,  391,  417,  443,  401,  427,  453,  411,  437,
+     395,  421,  447,  405,  431,  388,  414,  440,  398,  424,  450,  408,  434,  392,  418,  444,
+     402,  428,  454,  412,  438,  396,  422,  448,  406,  432,  390,  416,  442,  400,  426,  452,
+     410,  436,  394,  420,  446,  404,  430,  456,  482,  508,  466,  492,  518,  476,  502,  460,
+     486,  512,  470,  496,  522,  480,  506,  464,  490,  516,  474,  500,  458,  484,  510,  468,
+     494,  520,  478,  504,  462,  488,  514,  472,  498,  455,  481,  507,  465,  491,  517,  475,
+     501,  459,  485,  511,  469,  495,  521,  479,  505,  463,  489,  515,  473,  499,  457,  483,
+     509,  467,  493,  519,  477,  503,  461,  487,  513,  471,  497,  523,  557,  591,  536,  570,
+     604,  549,  583,  528,  562,  596,  541,  575,  609,  554,  588,  533,  567,  601,  546,  580,
+     525,  559,  593,  538,  572,  606,  551,  585,  530,  564,  598,  543,  577,  611,  556,  590,
+     535,  569,  603,  548,  582,  527,  561,  595,  540,  574,  608,  553,  587,  532,  566,  600,
+     545,  579,  524,  558,  592,  537,  571,  605,  550,  584,  529,  563,  597,  542,  576,  610,
+     555,  589,  534,  568,  602,  547,  581,  526,  560,  594,  539,  573,  607,  552,  586,  531,
+     565,  599,  544,  578,  612,  646,  680,  625,  659,  693,  638,  672,  617,  651,  685,  630,
+     664,  698,  643,  677,  622,  656,  690,  635,  669,  614,  648,  682,  627,  661,  695,  640,
+     674,  619,  653,  687,  632,  666,  700,  645,  679,  624,  658,  692,  637,  671,  616,  650,
+     684,  629,  663,  697,  642,  676,  621,  655,  689,  634,  668,  613,  647,  681,  626,  660,
+     694,  639,  673,  618,  652,  686,  631,  665,  699,  644,  678,  623,  657,  691,  636,  670,
+     615,  649,  683,  628,  662,  696,  641,  675,  620,  654,  688,  633,  667,  701,  735,  769,
+     714,  748,  782,  727,  761,  706,  740,  774,  719,  753,  787,  732,  766,  711,  745,  779,
+     724,  758,  703,  737,  771,  716,  750,  784,  729,  763,  708,  742,  776,  721,  755,  789,
+     734,  768,  713,  747,  781,  726,  760,  705,  739,  773,  718,  752,  786,  731,  765,  710,
+     744,  778,  723,  757,  702,  736,  770,  715,  749,  783,  728,  762,  707,  741,  775,  720,
+     754,  788,  733,  767,  712,  746,  780,  725,  759,  704,  738,  772,  717,  751,  785,  730,
+     764,  709,  743,  777,  722,  756,  790,  824,  858,  803,  837,  871,  816,  850,  795,  829,
+     863,  808,  842,  876,  821,  855,  800,  834,  868,  813,  847,  792,  826,  860,  805,  839,
+     873,  818,  852,  797,  831,  865,  810,  844,  878,  823,  857,  802,  836,  870,  815,  849,
+     794,  828,  862,  807,  841,  875,  820,  854,  799,  833,  867,  812,  846,  791,  825,  859,
+     804,  838,  872,  817,  851,  796,  830,  864,  809,  843,  877,  822,  856,  801,  835,  869,
+     814,  848,  793,  827,  861,  806,  840,  874,  819,  853,  798,  832,  866,  811,  845,  879,
+     934,  989,  900,  955, 1010,  921,  976,  887,  942,  997,  908,  963, 1018,  929,  984,  895,
+     950, 1005,  916,  971,  882,  937,  992,  903,  958, 1013,  924,  979,  890,  945, 1000,  911,
+     966, 1021,  932,  987,  898,  953, 1008,  919,  974,  885,  940,  995,  906,  961, 1016,  927,
+     982,  893,  948, 1003,  914,  969,  880,  935,  990,  901,  956, 1011,  922,  977,  888,  943,
+     998,  909,  964, 1019,  930,  985,  896,  951, 1006,  917,  972,  883,  938,  993,  904,  959,
+    1014,  925,  980,  891,  946, 1001,  912,  967, 1022,  933,  988,  899,  954, 1009,  920,  975,
+     886,  941,  996,  907,  962, 1017,  928,  983,  894,  949, 1004,  915,  970,  881,  936,  991,
+     902,  957, 1012,  923,  978,  889,  944,  999,  910,  965, 1020,  931,  986,  897,  952, 1007,
+     918,  973,  884,  939,  994,  905,  960, 1015,  926,  981,  892,  947, 1002,  913,  968, 1023,
+};
+
+void GoldenArtTask::transmit(
+    APA102::LED<int16_t> const *	led,
+    FrameStats::Scope &			frameScope)
+{
+    // transfer APA102::LED<int16_t> renderings to the back message layout
+    // with gamma correction and scaled encodings.
+    // the front message may still be in transmission.
+    APA102::Message<ledCount> & message1 {frames.back()};
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    // forkJoin is only for the (rendering) GoldenArtTask
+    APA102::encode(message1.encodings, led, ledCount, gammaEncode, layout);
+#else
+    forkJoin([this, &message1, led](unsigned side) {
+	// each side encodes half of the LEDs
+	auto const begin {side ? ledCount / 2 : 0};
+	auto const end {side ? ledCount : ledCount / 2};
+	APA102::encode(message1.encodings, led + begin, end - begin,
+	    gammaEncode, layout + begin);
+    });
+#endif
+
+    transmitBack(frameScope);
+}
+
+void GoldenArtTask::transmitBack(FrameStats::Scope & frameScope) {
+    APA102::Message<ledCount> & message1 {frames.back()};
+
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+    captureRecorder.record(esp_timer_get_time(), message1.encodings);
+#endif
+
+    // wait for the front message to be done (it usually is)
+    // before we make the back message the front
+    // and queue (the prefix of) it that changed for transmission.
+    // we will not wait for this to complete.
+    // every so often, queue all of it.
+    frameScope.next(FrameStats::spiWait);
+    transaction.wait();
+    bool const full {++unrefreshed >= CONFIG_ARTLIGHT_APA102_REFRESH};
+    if (std::size_t const length = frames.flipPrefix(full)) {
+	if (full) unrefreshed = 0;
+	transaction.queue(SPI::Transaction::Config()
+	    .tx_buffer_(&message1)
+	    .length_(length));
+    } else {
+	frameStats.count(FrameStats::unchanged);
+    }
+}
+
+void GoldenArtTask::transmit0(APA102::Message<1> const & message0) {
+    // SPI::Transaction constructor queues the message.
+    // SPI::Transaction destructor waits for result.
+    if (unchanged(message0)) {
+	frameStats.count(FrameStats::unchanged);
+    } else {
+	SPI::Transaction transaction0(spiDevice[0], SPI::Transaction::Config()
+	    .tx_buffer_(&message0)
+	    .length_(message0.length()));
+    }
+}
+
+void GoldenArtTask::play(FrameStats::Scope & frameScope) {
+    if (!playback) return;
+    std::vector<uint32_t> const & encodings
+	{playback->player(esp_timer_get_time())};
+    if (encodings.empty()) return;	// not started
+    // the stream may have been wired (laid out) differently
+    std::vector<uint16_t> const & streamLayout
+	{playback->player.stream().layout()};
+    APA102::Message<ledCount> & message1 {frames.back()};
+    for (size_t i = 0; i < ledCount; ++i) {
+	message1.encodings[layout[i]] = encodings[streamLayout[i]];
+    }
+    transmitBack(frameScope);
+}
+
+void GoldenArtTask::update_() {
+    FrameStats::Scope frameScope {frameStats, FrameStats::render};
+
+    // construct static PerlinNoiseQ16 objects
     static std::mt19937 rng;
-    static PerlinNoise perlinNoise[] {rng, rng, rng, rng, rng};
+    static PerlinNoiseQ16 perlinNoise[] {rng, rng, rng, rng, rng};
     // Perlin noise repeats every 256 units.
     constexpr unsigned perlinNoisePeriod {256};
     constexpr uint64_t perlinNoisePeriodMicroseconds
@@ -410,6 +676,30 @@ void GoldenArtTask::update_() {
 	}
     }
 
+    if (Mode::Value::playback == mode.value) {
+	// pre-rendered frames are already encoded
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+	// unless the last is still pending (frames are played in time)
+	if (!playPosted.exchange(true)) {
+	    transmitTask.io.post(playMemory.wrap([this](){
+		playPosted = false;
+		FrameStats::Scope frameScope {frameStats, FrameStats::encode};
+		play(frameScope);
+	    }));
+	}
+#else
+	frameScope.next(FrameStats::encode);
+	play(frameScope);
+#endif
+	transmit0(message0);
+	return;
+    }
+    if (Mode::Value::stream == mode.value) {
+	// pixelStream updates frames
+	transmit0(message0);
+	return;
+    }
+
     // clip lux blacks and whites for value to fade from
     float lux {luxSensor ? luxSensor->getLux() : white};
     if (black > lux) lux = 0.0f;
@@ -427,7 +717,21 @@ void GoldenArtTask::update_() {
     // render with a 12 bit resolution using 16 bit signed integers.
     // these values can be clipped to 12 bit unsigned values later and
     // encoded into 8 bits later.
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    // into the back slot of the ring, if it is not full
+    Slot * const slot {ring.back()};
+    if (!slot) {
+	frameStats.count(FrameStats::dropped);
+	if (!(ring.drops() % 64)) {
+	    ESP_LOGW(name, "ring drops %u", ring.drops());
+	}
+	return;
+    }
+    APA102::LED<int16_t> (&led)[ledCount] = slot->led;
+    std::fill(std::begin(led), std::end(led), APA102::LED<int16_t> {});
+#else
     APA102::LED<int16_t> led[ledCount];
+#endif
 
     float const secondsSinceTwelveLocaltime {
 	smoothTime.millisecondsSinceTwelveLocaltime(microsecondsSinceBoot)
@@ -447,6 +751,13 @@ void GoldenArtTask::update_() {
 	    float ignore;
 	    auto const wavePhase {std::modf(secondsSinceTwelveLocaltime / wavePeriod, &ignore)};
 
+	    // dials that must be rendered (again) are rendered on
+	    // alternating sides of forkJoin. then, all dials are gathered.
+	    DialRender render[dialCount];
+	    unsigned renderCount {0};
+	    RimGather gather[dialCount];
+	    unsigned gatherCount {0};
+
 	    auto * width_	{width};
 	    auto * curl_	{curl};
 	    auto * length_	{length};
@@ -459,7 +770,7 @@ void GoldenArtTask::update_() {
 		    constexpr auto shift {levelEndLog2 - 8};
 
 		    auto	const rim_	{rim[*curl_]};
-		    auto	const rim__	{&rim_.data[std::min(*length_, rim_.size - 1)]};
+		    auto	const rim__	{&rim_.data[std::min<std::size_t>(*length_, rim_.size - 1)]};
 		    auto	const rimSize	{fibonacci(rim__->fibonacciIndex)};
 		    auto	const position	{(*unit_)(secondsSinceTwelveLocaltime)};
 		    auto	const width__	{2.0f * *width_ / 64.0f};
@@ -474,63 +785,56 @@ void GoldenArtTask::update_() {
 
 		    APA102::LED<int16_t> const faded
 			{Blend<APA102::LED<int16_t>>(background, *foreground)(fade)};
-		    Blend<APA102::LED<int16_t>>	const blend {background, faded};
-		    HalfDial	const dial	{position, !(1 & rim__->fibonacciIndex)};
-		    BellCurve<>	const bell	{0.0f, width__};
-
-		    std::function<APA102::LED<int16_t>(float)> render {[](float){return APA102::LED<int16_t>();}};
-		    switch (shape[i].value) {
-			case Shape::Value::bell: {
-			    render = [dial, bell, blend](float place) {
-				float const offset {dial(place)};
-				return blend(bell(offset));
-			    };
-			} break;
-			case Shape::Value::wave: {
-			    auto const waveWidth {2.0f / rimSize};
-			    auto wavePosition {wavePhase * waveWidth};
-			    if (1 & rimSize) {
-				// for an odd rimSize, there is an ugly seam
-				// where the wrap-around wave meets itself
-				// because the sides will not be in phase.
-				// we can hide this seam in the far half of
-				// the dial by  shifting the wavePosition.
-				// the shift must be an integral multiple
-				// of waveWidth to preserve the wavePeriod.
-				wavePosition += waveWidth * (0
-				    + ((1 & rim__->fibonacciIndex) ? -1 : 1)
-				    + std::floor((position - 0.5f) / waveWidth));
-			    }
-			    WaveDial const wave {wavePosition, waveWidth};
-			    render = [dial, bell, wave, blend](float place) {
-				auto const offset {dial(place)};
-				return blend(bell(offset) * wave(place));
-			    };
-			} break;
-			case Shape::Value::bloom: {
-			    BumpCurve bump{0.0f, width__};
-			    BloomCurve bloom{0.0f, width__,
-				phaseIn(microsecondsSinceBoot,
-				    microsecondsPerSecond << 1)};
-			    render = [dial, bump, bloom, blend](float place) {
-				float const offset {dial(place)};
-				return blend(bump(offset) * bloom(offset));
-			    };
-			} break;
+
+		    // a dial with an unchanged key is not rendered again.
+		    // the key has everything the rendering depends on,
+		    // exactly, so a hit is what would have been rendered.
+		    // animated (wave and bloom) dials change every frame.
+		    auto & cache {dialCache[i]};
+		    bool const animated {Shape::Value::bell != shape[i].value};
+		    bool const hit {!animated && cache.valid
+			    && cache.curl	== *curl_
+			    && cache.length	== *length_
+			    && cache.shape	== shape[i].value
+			    && cache.width	== *width_
+			    && cache.position	== position
+			    && cache.faded.part.red	== faded.part.red
+			    && cache.faded.part.green	== faded.part.green
+			    && cache.faded.part.blue	== faded.part.blue};
+		    if (hit) {
+			frameStats.count(FrameStats::dialCacheHits);
+		    } else {
+			if (!animated) {
+			    frameStats.count(FrameStats::dialCacheMisses);
+			}
+			cache.valid	= !animated;
+			cache.curl	= *curl_;
+			cache.length	= *length_;
+			cache.shape	= shape[i].value;
+			cache.width	= *width_;
+			cache.position	= position;
+			cache.faded	= faded;
 		    }
+		    APA102::LED<int16_t> * const values {cache.values};
 
 		    auto const closest	{static_cast<unsigned>(
 			std::floor(position * rimSize + 0.5f)
 		    ) % rimSize};
-		    auto const * kp {rim__->sequence};
-		    for (auto j {0u}; j < rimSize; ++j) {
-			auto const k {*kp++};
-			APA102::LED<int16_t> value {j == closest ? faded
-			    : render(static_cast<float>(j) / rimSize)};
-			for (auto const & l: Path{rim__->end - 1u - k, rimSize}) {
-			    led[l] = led[l] + value;
-			}
-		    }
+
+		    if (!hit) render[renderCount++] = {
+			shape[i].value,
+			rimSize,
+			!(1 & rim__->fibonacciIndex),
+			closest,
+			position,
+			width__,
+			wavePhase,
+			phaseIn(microsecondsSinceBoot, microsecondsPerSecond << 1),
+			faded,
+			values,
+		    };
+
+		    gather[gatherCount++] = {rim__->end, rim__->slot, values};
 		}
 
 		if (rimSwirl) break;
@@ -541,6 +845,18 @@ void GoldenArtTask::update_() {
 		++color_;
 		++unit_;
 	    }
+
+	    // fork only when there is work to share
+	    if (renderCount) forkJoin([&render, renderCount](unsigned side) {
+		for (auto j {side}; j < renderCount; j += 2) {
+		    render[j].render();
+		}
+	    });
+	    if (gatherCount) forkJoin([&gather, gatherCount, &led](unsigned side) {
+		for (auto j {0u}; j < gatherCount; ++j) {
+		    gather[j].add(led, side);
+		}
+	    });
 	} if (!rimSwirl) break;	// else, fall through
 	// no break
 	case Mode::Value::swirl: {
@@ -572,21 +888,34 @@ void GoldenArtTask::update_() {
 	    )]};
 	    auto const n {fibonacci(rim->fibonacciIndex)};
 
-	    auto kp {rim->sequence};
-	    for (auto j = 0; j < n; ++j) {
-		auto k {*kp++};
+	    // evaluate the noise for all places (and R, G, B) in one batch
+	    static PerlinNoiseQ16 const * const rgbNoise[] {
+		&perlinNoise[0], &perlinNoise[1], &perlinNoise[2]};
+	    float xs[rimSizeMax], ys[rimSizeMax], zs[rimSizeMax];
+	    for (auto j = 0u; j < n; ++j) {
 		float const a {tau * j / n};
-		float const x {r * std::cos(a)};
-		float const y {r * std::sin(a)};
-		APA102::LED<int16_t> value {
-		    static_cast<int16_t>(levelEnd * std::nextafter(levelContrast(perlinNoise[0].noise0_1(x, y, z)), 0.0f)),
-		    static_cast<int16_t>(levelEnd * std::nextafter(levelContrast(perlinNoise[1].noise0_1(x, y, z)), 0.0f)),
-		    static_cast<int16_t>(levelEnd * std::nextafter(levelContrast(perlinNoise[2].noise0_1(x, y, z)), 0.0f))
+		xs[j] = r * std::cos(a);
+		ys[j] = r * std::sin(a);
+		zs[j] = z;
+	    }
+	    float rgb[rimSizeMax][3];
+	    PerlinNoiseQ16::octaveNoise0_1(rgbNoise, 3, n, xs, ys, zs, &rgb[0][0]);
+	    APA102::LED<int16_t> values[rimSizeMax];
+	    for (auto j = 0u; j < n; ++j) {
+		values[j] = {
+		    static_cast<int16_t>(levelEnd * std::nextafter(levelContrast(rgb[j][0]), 0.0f)),
+		    static_cast<int16_t>(levelEnd * std::nextafter(levelContrast(rgb[j][1]), 0.0f)),
+		    static_cast<int16_t>(levelEnd * std::nextafter(levelContrast(rgb[j][2]), 0.0f))
 		};
-		for (auto const & l: Path{rim->end - 1u - k, n}) {
-		    led[l] = rimSwirl ? led[l] + value : value;
-		}
 	    }
+	    RimGather const gather {rim->end, rim->slot, values};
+	    forkJoin([&gather, rimSwirl, &led](unsigned side) {
+		if (rimSwirl) {
+		    gather.add(led, side);
+		} else {
+		    gather.assign(led, side);
+		}
+	    });
 	} break;
 	default: {
 	    float const x {(microsecondsSinceBoot % perlinNoisePeriodMicroseconds)
@@ -602,127 +931,52 @@ void GoldenArtTask::update_() {
 	} break;
     }
 
-    // the natural rendering indeces need to be mapped to the path indeces
-    // that reflect the way the LEDs are actually wired (addressed).
-    // this order is conducive for board/trace layout.
-    // see easyeda/projects/golden/scripts/goldenPath.js
-    static constexpr uint16_t layout[ledCount] {
-	   0,    4,    8,    2,    6,    9,    3,    7,    1,    5,   22,   13,   18,   10,   15,   20,
-	  12,   17,   23,   14,   19,   11,   16,   21,   29,   38,   24,   33,   42,   27,   36,   45,
-	  31,   40,   25,   34,   43,   28,   37,   47,   32,   41,   26,   35,   44,   30,   39,   49,
-	  61,   73,   54,   66,   46,   58,   70,   51,   63,   75,   56,   68,   48,   60,   72,   53,
-	  65,   77,   57,   69,   50,   62,   74,   55,   67,   79,   59,   71,   52,   64,   76,   89,
-	 102,   81,   94,  107,   86,   99,   78,   91,  104,   83,   96,  109,   88,  101,   80,   93,
-	 106,   85,   98,  111,   90,  103,   82,   95,  108,   87,  100,  114,   92,  105,   84,   97,
-	 110,  130,  151,  117,  138,  159,  125,  146,  112,  133,  154,  120,  141,  162,  128,  149,
-	 115,  136,  157,  123,  144,  165,  131,  152,  118,  139,  160,  126,  147,  113,  134,  155,
-	 121,  142,  163,  129,  150,  116,  137,  158,  124,  145,  166,  132,  153,  119,  140,  161,
-	 127,  148,  169,  135,  156,  122,  143,  164,  185,  206,  172,  193,  214,  180,  201,  167,
-	 188,  209,  175,  196,  217,  183,  204,  170,  191,  212,  178,  199,  220,  186,  207,  173,
-	 194,  215,  181,  202,  168,  189,  210,  176,  197,  218,  184,  205,  171,  192,  213,  179,
-	 200,  221,  187,  208,  174,  195,  216,  182,  203,  224,  190,  211,  177,  198,  219,  240,
-	 261,  227,  248,  269,  235,  256,  222,  243,  264,  230,  251,  272,  238,  259,  225,  246,
-	 267,  233,  254,  275,  241,  262,  228,  249,  270,  236,  257,  223,  244,  265,  231,  252,
-	 273,  239,  260,  226,  247,  268,  234,  255,  276,  242,  263,  229,  250,  271,  237,  258,
-	 279,  245,  266,  232,  253,  274,  296,  317,  283,  304,  325,  291,  312,  277,  299,  320,
-	 286,  307,  328,  294,  315,  281,  302,  323,  289,  310,  331,  297,  318,  284,  305,  326,
-	 292,  313,  278,  300,  321,  287,  308,  329,  295,  316,  282,  303,  324,  290,  311,  333,
-	 298,  319,  285,  306,  327,  293,  314,  280,  301,  322,  288,  309,  330,  353,  374,  340,
-	 361,  382,  348,  369,  335,  356,  377,  343,  364,  385,  351,  372,  338,  359,  380,  346,
-	 367,  332,  354,  375,  341,  362,  383,  349,  370,  336,  357,  378,  344,  365,  387,  352,
-	 373,  339,  360,  381,  347,  368,  334,  355,  376,  342,  363,  384,  350,  371,  337,  358,
-	 379,  345,  366,  389,  415,  441,  399,  425,  451,  409,  435,  393,  419,  445,  403,  429,
-	 386,  413,  439,  397,  423,  449,  407,  433,  391,  417,  443,  401,  427,  453,  411,  437,
-	 395,  421,  447,  405,  431,  388,  414,  440,  398,  424,  450,  408,  434,  392,  418,  444,
-	 402,  428,  454,  412,  438,  396,  422,  448,  406,  432,  390,  416,  442,  400,  426,  452,
-	 410,  436,  394,  420,  446,  404,  430,  456,  482,  508,  466,  492,  518,  476,  502,  460,
-	 486,  512,  470,  496,  522,  480,  506,  464,  490,  516,  474,  500,  458,  484,  510,  468,
-	 494,  520,  478,  504,  462,  488,  514,  472,  498,  455,  481,  507,  465,  491,  517,  475,
-	 501,  459,  485,  511,  469,  495,  521,  479,  505,  463,  489,  515,  473,  499,  457,  483,
-	 509,  467,  493,  519,  477,  503,  461,  487,  513,  471,  497,  523,  557,  591,  536,  570,
-	 604,  549,  583,  528,  562,  596,  541,  575,  609,  554,  588,  533,  567,  601,  546,  580,
-	 525,  559,  593,  538,  572,  606,  551,  585,  530,  564,  598,  543,  577,  611,  556,  590,
-	 535,  569,  603,  548,  582,  527,  561,  595,  540,  574,  608,  553,  587,  532,  566,  600,
-	 545,  579,  524,  558,  592,  537,  571,  605,  550,  584,  529,  563,  597,  542,  576,  610,
-	 555,  589,  534,  568,  602,  547,  581,  526,  560,  594,  539,  573,  607,  552,  586,  531,
-	 565,  599,  544,  578,  612,  646,  680,  625,  659,  693,  638,  672,  617,  651,  685,  630,
-	 664,  698,  643,  677,  622,  656,  690,  635,  669,  614,  648,  682,  627,  661,  695,  640,
-	 674,  619,  653,  687,  632,  666,  700,  645,  679,  624,  658,  692,  637,  671,  616,  650,
-	 684,  629,  663,  697,  642,  676,  621,  655,  689,  634,  668,  613,  647,  681,  626,  660,
-	 694,  639,  673,  618,  652,  686,  631,  665,  699,  644,  678,  623,  657,  691,  636,  670,
-	 615,  649,  683,  628,  662,  696,  641,  675,  620,  654,  688,  633,  667,  701,  735,  769,
-	 714,  748,  782,  727,  761,  706,  740,  774,  719,  753,  787,  732,  766,  711,  745,  779,
-	 724,  758,  703,  737,  771,  716,  750,  784,  729,  763,  708,  742,  776,  721,  755,  789,
-	 734,  768,  713,  747,  781,  726,  760,  705,  739,  773,  718,  752,  786,  731,  765,  710,
-	 744,  778,  723,  757,  702,  736,  770,  715,  749,  783,  728,  762,  707,  741,  775,  720,
-	 754,  788,  733,  767,  712,  746,  780,  725,  759,  704,  738,  772,  717,  751,  785,  730,
-	 764,  709,  743,  777,  722,  756,  790,  824,  858,  803,  837,  871,  816,  850,  795,  829,
-	 863,  808,  842,  876,  821,  855,  800,  834,  868,  813,  847,  792,  826,  860,  805,  839,
-	 873,  818,  852,  797,  831,  865,  810,  844,  878,  823,  857,  802,  836,  870,  815,  849,
-	 794,  828,  862,  807,  841,  875,  820,  854,  799,  833,  867,  812,  846,  791,  825,  859,
-	 804,  838,  872,  817,  851,  796,  830,  864,  809,  843,  877,  822,  856,  801,  835,  869,
-	 814,  848,  793,  827,  861,  806,  840,  874,  819,  853,  798,  832,  866,  811,  845,  879,
-	 934,  989,  900,  955, 1010,  921,  976,  887,  942,  997,  908,  963, 1018,  929,  984,  895,
-	 950, 1005,  916,  971,  882,  937,  992,  903,  958, 1013,  924,  979,  890,  945, 1000,  911,
-	 966, 1021,  932,  987,  898,  953, 1008,  919,  974,  885,  940,  995,  906,  961, 1016,  927,
-	 982,  893,  948, 1003,  914,  969,  880,  935,  990,  901,  956, 1011,  922,  977,  888,  943,
-	 998,  909,  964, 1019,  930,  985,  896,  951, 1006,  917,  972,  883,  938,  993,  904,  959,
-	1014,  925,  980,  891,  946, 1001,  912,  967, 1022,  933,  988,  899,  954, 1009,  920,  975,
-	 886,  941,  996,  907,  962, 1017,  928,  983,  894,  949, 1004,  915,  970,  881,  936,  991,
-	 902,  957, 1012,  923,  978,  889,  944,  999,  910,  965, 1020,  931,  986,  897,  952, 1007,
-	 918,  973,  884,  939,  994,  905,  960, 1015,  926,  981,  892,  947, 1002,  913,  968, 1023,
-    };
 
-    // transfer APA102::LED<int16_t> renderings to message layout
-    // with gamma correction and scaled encodings.
-    APA102::Message<ledCount> message1;
-    auto i = 0u;
-    for (auto & e: led) {
-	int16_t ps[3] {
-	    e.part.red,
-	    e.part.green,
-	    e.part.blue,
-	};
-	for (auto & p: ps) {
-	    if (p) {
-		constexpr int16_t max {0xfff};
-		auto out {static_cast<int16_t>(
-		    0.5f + max * std::pow(static_cast<float>(p) / max, gamma))};
-		if (!out) out = 1;
-		p = out;
-	    }
-	}
-	message1.encodings[layout[i++]]
-	    = APA102::LED<int16_t>(ps[0], ps[1], ps[2]);
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    // hand off this rendering to the transmitTask,
+    // waking it only if it is idle.
+    frameScope.next(FrameStats::handoff);
+    if (ring.push()) {
+	transmitTask.io.post(drainMemory.wrap([this](){drain();}));
     }
+    frameScope.next(FrameStats::spiWait);
+#else
+    frameScope.next(FrameStats::encode);
+    transmit(led, frameScope);
+#endif
 
-    // SPI::Transaction constructor queues the message.
-    // SPI::Transaction destructor waits for result.
-    {
-	SPI::Transaction transaction0(spiDevice[0], SPI::Transaction::Config()
-	    .tx_buffer_(&message0)
-	    .length_(message0.length()));
-	SPI::Transaction transaction1(spiDevice[1], SPI::Transaction::Config()
-	    .tx_buffer_(&message1)
-	    .length_(message1.length()));
-    }
+    transmit0(message0);
 }
 
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+void GoldenArtTask::drain() {
+    do {
+	while (Slot const * const slot = ring.front()) {
+	    FrameStats::Scope frameScope {frameStats, FrameStats::encode};
+	    transmit(slot->led, frameScope);
+	    ring.pop();
+	}
+    } while (!ring.idle());
+}
+#endif
+
 void GoldenArtTask::update() {
-    // if the rate at which we complete work
-    // is less than the periodic demand for such work
-    // the work queue will eventually exhaust all memory.
-    if (updated++) {
-	// catch up to the rate of demand
-	ESP_LOGW(name, "update rate too fast. %u", updated - 1);
-	return;
-    }
+    frameStats.started();
     update_();
-    // ignore any queued update work
-    io.poll();
-    updated = 0;
+    frameScheduler.done();
 }
 
+GoldenArtTask::DialCache::DialCache() :
+    valid	{false},
+    curl	{},
+    length	{},
+    shape	{Shape::Value::bell},
+    width	{},
+    position	{},
+    faded	{},
+    values	{}
+{}
+
 static constexpr char const * const curlKey[DialPreferences::dialCount] {
     "aCurl",
     "bCurl",
@@ -737,24 +991,20 @@ static constexpr char const * const lengthKey[DialPreferences::dialCount] {
 void GoldenArtTask::curlObserved(size_t index, char const * value_) {
     unsigned value = fromString<unsigned>(value_);
     if (value < 6) {
-	io.post([this, index, value](){
-	    curl[index] = value;
-	});
+	curl[index] = value;
     }
 }
 void GoldenArtTask::lengthObserved(size_t index, char const * value_) {
     unsigned value = fromString<unsigned>(value_);
     if (value < 8) {
-	io.post([this, index, value](){
-	    length[index] = value;
-	});
+	length[index] = value;
     }
 }
 
 GoldenArtTask::GoldenArtTask(
     KeyValueBroker &	keyValueBroker)
 :
-    AsioTask		{"GoldenArtTask", 5, 0x10000, 1},
+    AsioTask		{"GoldenArtTask", 5, 0x8000, 1},
     TimePreferences	{io, keyValueBroker, 512},
     DialPreferences	{io, keyValueBroker},
 
@@ -784,9 +1034,21 @@ GoldenArtTask::GoldenArtTask(
 	    .clock_speed_hz_(8000000)	// see SPI_MASTER_FREQ_*
 	    .spics_io_num_(-1)		// no chip select
 	    .queue_size_(1)
+	    .post_cb_(SPI::AsyncTransaction::postCallback)
 	},
     },
 
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    transmitTask	{"goldenTransmit", 5, 4096, 0},
+    ring	{},
+    drainMemory	{},
+    playMemory	{},
+    playPosted	{false},
+#endif
+
+    frames	{},
+    transaction	{spiDevice[1], transmitIo()},
+
     // internal pullups on silicon are rather high (~50k?)
     // external 4.7k is still too high. external 1k works
     i2cMaster {
@@ -798,6 +1060,7 @@ GoldenArtTask::GoldenArtTask(
     },
 
     sensorTask	{},
+    forkJoin	{"goldenForkJoin", 5, 8192, 0},
     luxSensor	{[this]() -> LuxSensor * {
 	    try {
 		return new TSL2591LuxSensor(sensorTask.io, &i2cMaster);
@@ -810,6 +1073,25 @@ GoldenArtTask::GoldenArtTask(
 	    }
 	}()
     },
+    playback	{[this]() -> Playback * {
+	    try {
+		std::unique_ptr<Playback> playback_ {new Playback("frames")};
+		std::vector<uint16_t> const & streamLayout
+		    {playback_->player.stream().layout()};
+		if (!playback_->player
+			|| ledCount != streamLayout.size()
+			|| std::any_of(streamLayout.begin(), streamLayout.end(),
+			    [](uint16_t i){return ledCount <= i;})) {
+		    ESP_LOGW(name, "playback frames invalid: disabled");
+		    return nullptr;
+		}
+		return playback_.release();
+	    } catch (esp_err_t & e) {
+		ESP_LOGW(name, "playback %s (0x%x): disabled", esp_err_to_name(e), e);
+		return nullptr;
+	    }
+	}()
+    },
 
     mode	{Mode::clock},
     curl	{4, 2, 0,},
@@ -818,92 +1100,149 @@ GoldenArtTask::GoldenArtTask(
     white	{1.0f * (1 <<  4)},
     level	{},
     dim		{},
-    gamma	{10 / 10.f},
+    gammaEncode	{10 / 10.f},
 
-    modeObserver{keyValueBroker, "mode", mode.toString(),
+    modeObserver{keyValueBroker, "mode", mode.toString(), io,
 	[this](char const * value){
 	    Mode mode_(value);
-	    io.post([this, mode_](){
-		mode = mode_;
-	    });
+	    if (Mode::Value::playback == mode_.value
+		    && Mode::Value::playback != mode.value && playback) {
+		// play from the beginning
+		transmitIo().post([this](){
+		    playback->player.start(esp_timer_get_time());
+		});
+	    }
+	    if ((Mode::Value::stream == mode_.value)
+		    != (Mode::Value::stream == mode.value)) {
+		bool const streaming_ {Mode::Value::stream == mode_.value};
+		transmitIo().post([this, streaming_](){
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+		    // transmit what was rendered before the change now
+		    // so that it is not drained over the streamed back frame
+		    if (streaming_) drain();
+#endif
+		    // start with what is displayed
+		    if (streaming_) frames.copyFront();
+		    streaming = streaming_;
+		    // only listen for pixels while streaming
+		    if (streaming_) {
+			pixelStream.start();
+		    } else {
+			pixelStream.stop();
+		    }
+		});
+	    }
+	    mode = mode_;
 	}},
     curlObserver {
-	{keyValueBroker, curlKey[0], "4",
+	{keyValueBroker, curlKey[0], "4", io,
 	    [this](char const * value) {curlObserved(0, value);}},
-	{keyValueBroker, curlKey[1], "2",
+	{keyValueBroker, curlKey[1], "2", io,
 	    [this](char const * value) {curlObserved(1, value);}},
-	{keyValueBroker, curlKey[2], "0",
+	{keyValueBroker, curlKey[2], "0", io,
 	    [this](char const * value) {curlObserved(2, value);}},
     },
     lengthObserver {
-	{keyValueBroker, lengthKey[0], "2",
+	{keyValueBroker, lengthKey[0], "2", io,
 	    [this](char const * value) {lengthObserved(0, value);}},
-	{keyValueBroker, lengthKey[1], "1",
+	{keyValueBroker, lengthKey[1], "1", io,
 	    [this](char const * value) {lengthObserved(1, value);}},
-	{keyValueBroker, lengthKey[2], "0",
+	{keyValueBroker, lengthKey[2], "0", io,
 	    [this](char const * value) {lengthObserved(2, value);}},
     },
-    blackObserver {keyValueBroker, "black", "10",
+    blackObserver {keyValueBroker, "black", "10", io,
 	[this](char const * value_) {
 	    unsigned const value {fromString<unsigned>(value_)};
-	    io.post([this, value](){
-		black = 1.0f / (1 << value);
-	    });
+	    black = 1.0f / (1 << value);
 	}
     },
-    whiteObserver {keyValueBroker, "white", "4",
+    whiteObserver {keyValueBroker, "white", "4", io,
 	[this](char const * value_) {
 	    unsigned const value {fromString<unsigned>(value_)};
-	    io.post([this, value](){
-		white = 1.0f * (1 << value);
-	    });
+	    white = 1.0f * (1 << value);
 	}
     },
-    levelObserver{keyValueBroker, "level", "2048",
+    levelObserver{keyValueBroker, "level", "2048", io,
 	[this](char const * value_){
 	    float value {std::min(1.0f, (0.5f + fromString<unsigned>(value_)) / 4096.0f)};
 	    if (0.0f <= value && value <= 1.0f) {
-		io.post([this, value](){
-		    level = value;
-		});
+		level = value;
 	    }
 	}},
-    dimObserver{keyValueBroker, "dim", "4032",
+    dimObserver{keyValueBroker, "dim", "4032", io,
 	[this](char const * value_){
 	    float value {std::min(1.0f, (0.5f + fromString<unsigned>(value_)) / 4096.0f)};
 	    if (0.0f <= value && value <= 1.0f) {
-		io.post([this, value](){
-		    dim = value;
-		});
+		dim = value;
 	    }
 	}},
-    gammaObserver{keyValueBroker, "gamma", "10",
+    // gammaEncode is used where we encode
+    gammaObserver{keyValueBroker, "gamma", "10", transmitIo(),
 	[this](char const * value){
 	    unsigned const gamma_ = std::strtoul(value, nullptr, 10);
 	    if (5 <= gamma_ && gamma_ <= 30) {
-		io.post([this, gamma_](){
-		    gamma = gamma_ / 10.0f;
-		});
+		gammaEncode.gamma(gamma_ / 10.0f);
 	    }
 	}},
 
-    updated {0}
+    dialCache	{new DialCache[dialCount]},
+
+    frameStats	{keyValueBroker},
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+    captureSink		{CONFIG_ARTLIGHT_CAPTURE_BYTES},
+    // a key frame after a quarter of the ring, so that most of it is kept
+    captureRecorder	{captureSink, Capture::Chip::apa102, ledCount, layout,
+			    CONFIG_ARTLIGHT_CAPTURE_BYTES / 4},
+#endif
+    unchanged	{CONFIG_ARTLIGHT_APA102_REFRESH},
+    unrefreshed	{0},
+    frameScheduler	{name, 25.0f, [this](){
+	frameStats.expired();
+	io.post([this](){
+	    this->update();
+	});
+    }},
+    streaming	{false},
+    pixelStream	{"goldenStream", transmitIo(), keyValueBroker,
+	"_streamPort", "4048",
+	[this](size_t offset, uint8_t const * rgb, size_t count) {
+	    if (!streaming || ledCount <= offset) return;
+	    // from rendering order to wiring order (layout)
+	    APA102::Message<ledCount> & message1 {frames.back()};
+	    size_t const end {std::min(ledCount, offset + count)};
+	    for (; offset < end; ++offset, rgb += 3) {
+		message1.encodings[layout[offset]]
+		    = APA102::LED<> {rgb[0], rgb[1], rgb[2]};
+	    }
+	},
+	[this]() {
+	    if (!streaming) return;
+	    FrameStats::Scope frameScope {frameStats, FrameStats::encode};
+	    transmitBack(frameScope);
+	    // continue to update what is displayed
+	    frames.copyFront();
+	},
+	frameStats}
 {
     tinyPicoLedPower.set_level(0);	// high side switch, low (0) turns it on
+    ESP_LOGI(name, "rim gather tables %u bytes",
+	static_cast<unsigned>(rimGatherSize()));
 }
 
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+std::string GoldenArtTask::capture() const {
+    return captureSink.copy();
+}
+#endif
+
 void GoldenArtTask::run() {
     sensorTask.start();
+    forkJoin.start();
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    transmitTask.start();
+#endif
 
-    // asio timers are not supported
-    // adapt a FreeRTOS timer to post timeout to this task.
-    Timer updateTimer(name, 4, true, [this](){
-	io.post([this](){
-	    this->update();
-	});
-    });
-
-    updateTimer.start();
+    frameScheduler.start();
 
     // create some dummy work ...
     asio::io_service::work work(io);
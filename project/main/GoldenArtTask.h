@@ -1,30 +1,79 @@
 #pragma once
 
+#include <atomic>
+
+#include "sdkconfig.h"
+
+#include "APA102.h"
 #include "AsioTask.h"
+#include "Capture.h"
 #include "DialPreferences.h"
+#include "ForkJoin.h"
+#include "FrameRing.h"
+#include "FrameScheduler.h"
+#include "FrameStats.h"
+#include "GammaEncode.h"
+#include "HandlerMemory.h"
 #include "I2C.h"
 #include "KeyValueBroker.h"
 #include "LuxSensor.h"
 #include "Pin.h"
+#include "PixelStream.h"
+#include "Playback.h"
 #include "SensorTask.h"
 #include "SPI.h"
 #include "TimePreferences.h"
+#include "WorkTask.h"
 
 class GoldenArtTask: public AsioTask, TimePreferences, DialPreferences {
+public:
+    static size_t constexpr ledCount {1024};
+    static size_t constexpr rimSizeMax {144};	///< most places on any rim
+
 private:
     Pin			tinyPicoLedPower;
     SPI::Bus const	spiBus[2];
     SPI::Device const	spiDevice[2];
+
+#ifdef CONFIG_ARTLIGHT_GOLDEN_PIPELINE
+    /// frames rendered by this task are handed off through the ring
+    /// to the transmitTask (on the other core),
+    /// which encodes and transmits them (on spiDevice[1]).
+    WorkTask			transmitTask;
+    struct Slot {
+	APA102::LED<int16_t>	led[ledCount];
+    };
+    FrameRing<Slot, 2>		ring;
+    /// memory to post the drain of the ring and the play of a frame
+    /// (one at a time) to the transmitTask without allocation
+    HandlerMemory<>		drainMemory;
+    HandlerMemory<>		playMemory;
+    std::atomic<bool>		playPosted;
+
+    /// transmit the frames in the ring (from the transmitTask)
+    void drain();
+#endif
+
+    /// frames for spiDevice[1] are rendered in the back
+    /// while (the changed prefix of) the front is (asynchronously) transmitted.
+    APA102::Frames<ledCount>	frames;
+    SPI::AsyncTransaction	transaction;
     I2C::Master const	i2cMaster;
 
     SensorTask			sensorTask;
+
+    /// forkJoin shares rendering work with a task on the other core.
+    ForkJoin			forkJoin;
     std::unique_ptr<LuxSensor>	luxSensor;
 
+    /// pre-rendered frames for playback mode, if there are any
+    std::unique_ptr<Playback>	playback;
+
     struct Mode {
     private:
 	static char const * const string[];
     public:
-	enum Value {clock, swirl, solid} value;
+	enum Value {clock, swirl, solid, playback, stream} value;
 	Mode(Value);
 	Mode(char const *);
 	char const * toString() const;
@@ -36,7 +85,7 @@ private:
     float				white;
     float				level;
     float				dim;
-    float				gamma;
+    GammaEncode12			gammaEncode;
 
     KeyValueBroker::Observer const	modeObserver;
     KeyValueBroker::Observer const	curlObserver[dialCount];
@@ -47,11 +96,63 @@ private:
     KeyValueBroker::Observer const	dimObserver;
     KeyValueBroker::Observer const	gammaObserver;
 
-    unsigned updated;
+    /// A DialCache remembers the values last rendered on a dial's rim
+    /// and what they were rendered from.
+    /// A dial whose key has not changed need not be rendered again.
+    /// Animated shapes are never cached.
+    /// Hits and misses are counted in frameStats.
+    struct DialCache {
+	bool			valid;
+	unsigned		curl;
+	unsigned		length;
+	Shape::Value		shape;
+	float			width;
+	float			position;
+	APA102::LED<int16_t>	faded;		///< color, after fade
+	APA102::LED<int16_t>	values[rimSizeMax];
+	DialCache();
+    };
+    std::unique_ptr<DialCache[]> const	dialCache;	// [dialCount]
+
+    FrameStats				frameStats;
+
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+    /// frames transmitted on spiDevice[1] are recorded in captureSink
+    Capture::RingSink			captureSink;
+    Capture::Recorder			captureRecorder;
+#endif
+
+    /// remember what was last transmitted on spiDevice[0]
+    APA102::Unchanged			unchanged;
+    /// frames since all of frames were transmitted on spiDevice[1]
+    unsigned				unrefreshed;
+
+    FrameScheduler			frameScheduler;
+
+    /// in stream mode, pixels from pixelStream are written
+    /// to the back frame and pushed (on the transmitIo task).
+    /// pixelStream is only started (its socket open) in stream mode.
+    bool				streaming;
+    PixelStream				pixelStream;
 
     void curlObserved(size_t index, char const * value);
     void lengthObserved(size_t index, char const * value);
 
+    /// the io_context of the task that encodes and transmits frames
+    asio::io_context & transmitIo();
+
+    /// encode led into the back frame and transmit (the changed prefix of) it
+    void transmit(APA102::LED<int16_t> const * led, FrameStats::Scope &);
+
+    /// transmit (the changed prefix of) the encoded back frame
+    void transmitBack(FrameStats::Scope &);
+
+    /// transmit message0 on spiDevice[0], if it changed
+    void transmit0(APA102::Message<1> const & message0);
+
+    /// copy the playback frame that is due into the back frame and transmit it
+    void play(FrameStats::Scope &);
+
     void update_();
     void update();
 
@@ -63,4 +164,9 @@ public:
 	KeyValueBroker &	keyValueBroker);
 
     ~GoldenArtTask() override;
+
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+    /// the recent frames that have been captured
+    std::string capture() const;
+#endif
 };
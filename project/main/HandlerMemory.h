@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/// HandlerMemory is where the operation of a handler posted to an
+/// asio::io_context is allocated so that posting one again and again
+/// (one at a time) does not allocate from the heap.
+/// A handler is made to use it with wrap
+/// (asio asks the handler, through its asio_handler_allocate hook,
+/// for the memory of its operation).
+/// asio releases this memory before it invokes the handler
+/// so the handler may post itself (or another) again.
+/// If the memory is in use (or too small), the heap is used instead.
+template <std::size_t size = 128>
+class HandlerMemory {
+private:
+    alignas(std::max_align_t) unsigned char	storage[size];
+    std::atomic<bool>				used;
+
+public:
+    HandlerMemory() : used {false} {}
+
+    HandlerMemory(HandlerMemory const &) = delete;
+    HandlerMemory & operator=(HandlerMemory const &) = delete;
+
+    void * allocate(std::size_t size_) {
+	if (size_ <= size && !used.exchange(true)) return storage;
+	return ::operator new(size_);
+    }
+
+    void deallocate(void * pointer) {
+	if (pointer == storage) {
+	    used = false;
+	} else {
+	    ::operator delete(pointer);
+	}
+    }
+
+    /// A Handler calls its function from memory allocated in handlerMemory
+    template <typename Function>
+    class Handler {
+    private:
+	HandlerMemory &	handlerMemory;
+	Function	function;
+
+    public:
+	Handler(HandlerMemory & handlerMemory_, Function const & function_)
+	:
+	    handlerMemory	(handlerMemory_),
+	    function		(function_)
+	{}
+
+	void operator()() {function();}
+
+	friend void * asio_handler_allocate(std::size_t size_, Handler * that) {
+	    return that->handlerMemory.allocate(size_);
+	}
+
+	friend void asio_handler_deallocate(
+	    void * pointer, std::size_t, Handler * that)
+	{
+	    that->handlerMemory.deallocate(pointer);
+	}
+    };
+
+    template <typename Function>
+    Handler<Function> wrap(Function const & function) {
+	return Handler<Function>(*this, function);
+    }
+};
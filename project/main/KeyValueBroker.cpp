@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
@@ -5,33 +7,76 @@
 
 #include "KeyValueBroker.h"
 
+KeyValueBroker::Entry::Entry(char const * key_)
+:
+    key		(key_),
+    valued	(false),
+    value	(),
+    defaulted	(false),
+    defaultValue(),
+    observers	(),
+    source	(nullptr)
+{}
+
 KeyValueBroker::KeyValueBroker(char const * name_)
 :
     name	(	name_),
-    observersFor	(),
+    entries		(),
+    index		(),
     generalObservers	(),
-    valueFor		(),
-    defaultValueFor	()
+    snapshot_		(),
+    stale		(true),
+    sources		(),
+    sourceCount		(0),
+    coalesced_		(0)
 {}
 
 KeyValueBroker::~KeyValueBroker() {}
 
-/* virtual */ bool KeyValueBroker::set(char const * key, char const * value) {
-    auto valueIt = valueFor.find(key);
-    if (valueIt != valueFor.end() && 0 == valueIt->second.compare(value)) {
+KeyValueBroker::Id KeyValueBroker::find(char const * key) const {
+    auto it = std::lower_bound(index.begin(), index.end(), key,
+	[this](Id id, char const * key) {
+	    return 0 > std::strcmp(entries[id].key.c_str(), key);
+	});
+    if (it != index.end() && 0 == entries[*it].key.compare(key)) return *it;
+    return entries.size();
+}
+
+KeyValueBroker::Id KeyValueBroker::intern(char const * key) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Id id = find(key);
+    if (id == entries.size()) {
+	entries.emplace_back(key);
+	index.insert(std::upper_bound(index.begin(), index.end(), id,
+	    [this](Id a, Id b) {
+		return entries[a].key < entries[b].key;
+	    }), id);
+    }
+    return id;
+}
+
+/* virtual */ bool KeyValueBroker::set(Id id, char const * value) {
+    Entry & entry = entries[id];
+    if (entry.valued && 0 == entry.value.compare(value)) {
 	return false;
     }
-    valueFor[key] = value;
+    entry.valued = true;
+    entry.value = value;
+    stale = true;
     return true;
 }
 
-/* virtual */ bool KeyValueBroker::get(char const * key, std::string & value) {
-    auto valueIt = valueFor.find(key);
-    if (valueIt == valueFor.end()) return false;
-    value = valueIt->second;
+/* virtual */ bool KeyValueBroker::get(Id id, std::string & value) {
+    Entry const & entry = entries[id];
+    if (!entry.valued) return false;
+    value = entry.value;
     return true;
 }
 
+/* virtual */ void KeyValueBroker::commit() {}
+
+/* virtual */ void KeyValueBroker::flush() {}
+
 static std::ostream & operator<<(
     std::ostream &	stream,
     std::string const &	value)
@@ -76,44 +121,110 @@ static std::ostream & operator<<(
     return stream;
 }
 
-static std::string serialize(std::map<std::string, std::string> const & map) {
+std::string KeyValueBroker::serialize(char const * key, char const * value) {
+    std::ostringstream stream;
+    stream << '{';
+    stream
+	<< '"'
+	<< std::string(key)
+	<< R"----(":")----"
+	<< std::string(value)
+	<< '"';
+    stream << '}';
+    return stream.str();
+}
+
+std::string KeyValueBroker::serialize(Batch const & batch) {
     std::ostringstream stream;
     size_t count = 0;
     stream << '{';
-    for (auto &e: map) {
+    for (auto const & pair: batch) {
 	if (count++) {
 	    stream << ',';
 	}
 	stream
 	    << '"'
-	    << e.first
+	    << pair.first
 	    << R"----(":")----"
-	    << e.second
+	    << pair.second
 	    << '"';
     }
     stream << '}';
     return stream.str();
 }
 
-std::string KeyValueBroker::serialize(char const * key, char const * value) {
+std::string KeyValueBroker::serializeDefault() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     std::ostringstream stream;
+    size_t count = 0;
     stream << '{';
-    stream
-	<< '"'
-	<< std::string(key)
-	<< R"----(":")----"
-	<< std::string(value)
-	<< '"';
+    for (auto id: index) {
+	Entry const & entry = entries[id];
+	if (!entry.defaulted) continue;
+	if (count++) {
+	    stream << ',';
+	}
+	stream
+	    << '"'
+	    << entry.key
+	    << R"----(":")----"
+	    << entry.defaultValue
+	    << '"';
+    }
     stream << '}';
     return stream.str();
 }
 
-std::string KeyValueBroker::serialize() {
-    return ::serialize(valueFor);
+KeyValueBroker::Snapshot::Snapshot(Batch && values_)
+:
+    values	(std::move(values_)),
+    json	(serialize(values))
+{}
+
+std::shared_ptr<KeyValueBroker::Snapshot const> KeyValueBroker::snapshot() {
+    if (stale) {
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	if (stale) {
+	    // anything set after this will make it stale again
+	    stale = false;
+	    Batch values;
+	    values.reserve(index.size());
+	    for (auto id: index) {
+		Entry const & entry = entries[id];
+		if (entry.valued) {
+		    values.emplace_back(entry.key, entry.value);
+		}
+	    }
+	    std::atomic_store(&snapshot_, std::shared_ptr<Snapshot const>(
+		new Snapshot(std::move(values))));
+	}
+    }
+    return std::atomic_load(&snapshot_);
 }
 
-std::string KeyValueBroker::serializeDefault() {
-    return ::serialize(defaultValueFor);
+std::string KeyValueBroker::serialize() {
+    std::shared_ptr<Snapshot const> const snapshot_ {snapshot()};
+    if (!sourceCount) return snapshot_->json;
+    // the values of Sources change without being set
+    // so they cannot be in a Snapshot.
+    // splice them in before its closing brace.
+    std::ostringstream stream;
+    stream.write(snapshot_->json.data(), snapshot_->json.size() - 1);
+    size_t count = snapshot_->values.size();
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (auto source: sources) {
+	if (count++) {
+	    stream << ',';
+	}
+	stream
+	    << '"'
+	    << std::string(source->key)
+	    << R"----(":")----"
+	    << (*source)()
+	    << '"';
+    }
+    stream << '}';
+    return stream.str();
 }
 
 void KeyValueBroker::publish(
@@ -122,42 +233,82 @@ void KeyValueBroker::publish(
     bool		fromPeer)
 {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    if (set(key, value)) {
-	auto observers = observersFor.find(key);
-	if (observers != observersFor.end()) {
-	    for (auto observer: *observers->second) {
-		ESP_LOGI(name, "publish observer %s %s", observer->key, value);
-		(*observer)(value);
-	    }
+    Id const id = intern(key);
+    if (entries[id].source) {
+	ESP_LOGW(name, "publish %s ignored: read-only", key);
+	return;
+    }
+    if (set(id, value)) {
+	commit();
+	// observers may (un)subscribe (and intern keys) as we go
+	// so do not hold on to references or iterators.
+	for (size_t i = 0; i < entries[id].observers.size(); ++i) {
+	    Observer const * observer = entries[id].observers[i];
+	    ESP_LOGI(name, "publish observer %s %s", observer->key, value);
+	    (*observer)(value);
 	}
-	for (auto generalObserver: generalObservers) {
+	for (size_t i = 0; i < generalObservers.size(); ++i) {
 	    ESP_LOGI(name, "publish generalObserver %s %s %d",
 		key, value, static_cast<int>(fromPeer));
-	    (*generalObserver)(key, value, fromPeer);
+	    (*generalObservers[i])(key, value, fromPeer);
+	}
+    }
+}
+
+void KeyValueBroker::publish(
+    Batch const &	batch,
+    bool		fromPeer)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<Id> ids;
+    Batch published;
+    ids.reserve(batch.size());
+    published.reserve(batch.size());
+    for (auto const & pair: batch) {
+	Id const id = intern(pair.first.c_str());
+	if (entries[id].source) {
+	    ESP_LOGW(name, "publish %s ignored: read-only", pair.first.c_str());
+	    continue;
+	}
+	if (set(id, pair.second.c_str())) {
+	    ids.push_back(id);
+	    published.push_back(pair);
+	}
+    }
+    if (published.empty()) return;
+    commit();
+    // observers may (un)subscribe (and intern keys) as we go
+    // so do not hold on to references or iterators.
+    for (size_t p = 0; p < published.size(); ++p) {
+	char const * const value = published[p].second.c_str();
+	for (size_t i = 0; i < entries[ids[p]].observers.size(); ++i) {
+	    Observer const * observer = entries[ids[p]].observers[i];
+	    ESP_LOGI(name, "publish observer %s %s", observer->key, value);
+	    (*observer)(value);
 	}
     }
+    for (size_t i = 0; i < generalObservers.size(); ++i) {
+	ESP_LOGI(name, "publish generalObserver batch of %u %d",
+	    static_cast<unsigned>(published.size()), static_cast<int>(fromPeer));
+	(*generalObservers[i])(published, fromPeer);
+    }
 }
 
 void KeyValueBroker::subscribe(Observer const & observer) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     bool haveValue;
     std::string value;
-    if ((haveValue = get(observer.key, value))) {
+    if ((haveValue = get(observer.id, value))) {
 	// observe the previously published value
 	ESP_LOGI(name, "subscribe %s %s", observer.key, value.c_str());
 	observer(value.c_str());
     }
     // remember this subscription
-    auto observersIt = observersFor.find(observer.key);
-    Observers * observers;
-    if (observersIt != observersFor.end()) {
-	observers = observersIt->second;
-    } else {
-	observersFor[observer.key] = observers = new Observers();
-    }
-    observers->insert(&observer);
+    entries[observer.id].observers.push_back(&observer);
     if (observer.defaultValue) {
-	defaultValueFor[observer.key] = observer.defaultValue;
+	Entry & entry = entries[observer.id];
+	entry.defaulted = true;
+	entry.defaultValue = observer.defaultValue;
 	if (!haveValue) {
 	    // publish the observer's defaultValue
 	    publish(observer.key, observer.defaultValue);
@@ -167,73 +318,267 @@ void KeyValueBroker::subscribe(Observer const & observer) {
 
 void KeyValueBroker::unsubscribe(Observer const & observer) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    auto observersIt = observersFor.find(observer.key);
-    if (observersIt != observersFor.end()) {
-	Observers * observers = observersIt->second;
-	auto observerIt = observers->find(&observer);
-	if (observerIt != observers->end()) {
-	    observers->erase(observerIt);
-	    if (!observers->size()) {
-		observersFor.erase(observer.key);
-		delete observers;
-	    }
-	}
+    std::vector<Observer const *> & observers = entries[observer.id].observers;
+    auto observerIt = std::find(observers.begin(), observers.end(), &observer);
+    if (observerIt != observers.end()) {
+	observers.erase(observerIt);
     }
 }
 
 void KeyValueBroker::generalSubscribe(GeneralObserver const & generalObserver) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    for (auto kv: valueFor) {
-	generalObserver(kv.first.c_str(), kv.second.c_str());
+    for (auto id: index) {
+	Entry const & entry = entries[id];
+	if (entry.valued) {
+	    generalObserver(entry.key.c_str(), entry.value.c_str());
+	}
     }
-    generalObservers.insert(&generalObserver);
+    generalObservers.push_back(&generalObserver);
 }
 
 void KeyValueBroker::generalUnsubscribe(GeneralObserver const & generalObserver) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    auto generalObserverIt = generalObservers.find(&generalObserver);
+    auto generalObserverIt = std::find(generalObservers.begin(),
+	generalObservers.end(), &generalObserver);
     if (generalObserverIt != generalObservers.end()) {
 	generalObservers.erase(generalObserverIt);
     }
 }
 
+void KeyValueBroker::addSource(Source const & source) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Entry & entry = entries[source.id];
+    if (entry.source) {
+	std::replace(sources.begin(), sources.end(), entry.source, &source);
+    } else {
+	sources.push_back(&source);
+	++sourceCount;
+    }
+    entry.source = &source;
+}
+
+void KeyValueBroker::removeSource(Source const & source) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Entry & entry = entries[source.id];
+    if (entry.source == &source) {
+	entry.source = nullptr;
+	sources.erase(std::find(sources.begin(), sources.end(), &source));
+	--sourceCount;
+    }
+}
+
+KeyValueBroker::Mailbox::Mailbox(
+    KeyValueBroker &	keyValueBroker_,
+    asio::io_context &	io_,
+    Deliver &&		deliver_)
+:
+    keyValueBroker	(keyValueBroker_),
+    io		(io_),
+    deliver	(std::move(deliver_)),
+    mutex	(),
+    letters	(),
+    coalesced_	(0),
+    closed	(false)
+{}
+
+void KeyValueBroker::Mailbox::put(
+    char const *	key,
+    char const *	value,
+    bool		fromPeer)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto & letter: letters) {
+	if (0 == letter.key.compare(key)) {
+	    // last value wins
+	    letter.value = value;
+	    letter.fromPeer = fromPeer;
+	    ++coalesced_;
+	    ++keyValueBroker.coalesced_;
+	    return;
+	}
+    }
+    bool const empty {letters.empty()};
+    letters.push_back({key, value, fromPeer});
+    if (empty) {
+	// (a drain may be in progress but it might not see this letter)
+	std::shared_ptr<Mailbox> self(shared_from_this());
+	io.post([self](){
+	    self->drain();
+	});
+    }
+}
+
+void KeyValueBroker::Mailbox::drain() {
+    if (closed) return;
+    std::vector<Letter> delivery;
+    {
+	std::lock_guard<std::mutex> lock(mutex);
+	delivery.swap(letters);
+    }
+    if (!delivery.empty()) {
+	deliver(delivery);
+    }
+}
+
+void KeyValueBroker::Mailbox::close() {
+    closed = true;
+}
+
+unsigned KeyValueBroker::Mailbox::coalesced() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return coalesced_;
+}
+
+
+KeyValueBroker::Observer::Observer(
+    KeyValueBroker &	keyValueBroker_,
+    char const *	key_,
+    char const *	defaultValue_,
+    Observe &&		observe_)
+:
+    keyValueBroker	(keyValueBroker_),
+    key			(key_),
+    id			(keyValueBroker.intern(key)),
+    defaultValue	(defaultValue_),
+    observe		(std::move(observe_)),
+    mailbox		()
+{
+    keyValueBroker.subscribe(*this);
+}
+
 KeyValueBroker::Observer::Observer(
     KeyValueBroker &	keyValueBroker_,
     char const *	key_,
     char const *	defaultValue_,
+    asio::io_context &	io,
     Observe &&		observe_)
 :
     keyValueBroker	(keyValueBroker_),
     key			(key_),
+    id			(keyValueBroker.intern(key)),
     defaultValue	(defaultValue_),
-    observe		(std::move(observe_))
+    observe		(std::move(observe_)),
+    mailbox		(std::make_shared<Mailbox>(
+	keyValueBroker, io,
+	[this](std::vector<Mailbox::Letter> const & letters) {
+	    for (auto const & letter: letters) {
+		observe(letter.value.c_str());
+	    }
+	}))
 {
     keyValueBroker.subscribe(*this);
 }
 
 KeyValueBroker::Observer::~Observer() {
     keyValueBroker.unsubscribe(*this);
+    if (mailbox) mailbox->close();
 }
 
 void KeyValueBroker::Observer::operator() (char const * value) const {
-    observe(value);
+    if (mailbox) {
+	mailbox->put(key, value, false);
+    } else {
+	observe(value);
+    }
 }
 
 KeyValueBroker::GeneralObserver::GeneralObserver(
     KeyValueBroker &	keyValueBroker_,
-    Observe &&		observe_)
+    Observe &&		observe_,
+    ObserveBatch &&	observeBatch_)
 :
     keyValueBroker	(keyValueBroker_),
-    observe		(std::move(observe_))
+    observe		(std::move(observe_)),
+    observeBatch	(std::move(observeBatch_)),
+    mailbox		()
+{
+    keyValueBroker.generalSubscribe(*this);
+}
+
+KeyValueBroker::GeneralObserver::GeneralObserver(
+    KeyValueBroker &	keyValueBroker_,
+    asio::io_context &	io,
+    Observe &&		observe_,
+    ObserveBatch &&	observeBatch_)
+:
+    keyValueBroker	(keyValueBroker_),
+    observe		(std::move(observe_)),
+    observeBatch	(std::move(observeBatch_)),
+    mailbox		(std::make_shared<Mailbox>(
+	keyValueBroker, io,
+	[this](std::vector<Mailbox::Letter> const & letters) {
+	    // observe each run of letters from the same source together
+	    Batch batch;
+	    for (size_t i = 0; i < letters.size(); ++i) {
+		Mailbox::Letter const & letter = letters[i];
+		if (!observeBatch) {
+		    observe(letter.key.c_str(), letter.value.c_str(),
+			letter.fromPeer);
+		    continue;
+		}
+		batch.emplace_back(letter.key, letter.value);
+		if (i + 1 == letters.size()
+			|| letters[i + 1].fromPeer != letter.fromPeer) {
+		    if (1 == batch.size()) {
+			observe(letter.key.c_str(), letter.value.c_str(),
+			    letter.fromPeer);
+		    } else {
+			observeBatch(batch, letter.fromPeer);
+		    }
+		    batch.clear();
+		}
+	    }
+	}))
 {
     keyValueBroker.generalSubscribe(*this);
 }
 
 KeyValueBroker::GeneralObserver::~GeneralObserver() {
     keyValueBroker.generalUnsubscribe(*this);
+    if (mailbox) mailbox->close();
 }
 
 void KeyValueBroker::GeneralObserver::operator() (
 	char const * key, char const * value, bool fromPeer) const {
-    observe(key, value, fromPeer);
+    if (mailbox) {
+	mailbox->put(key, value, fromPeer);
+    } else {
+	observe(key, value, fromPeer);
+    }
+}
+
+void KeyValueBroker::GeneralObserver::operator() (
+	Batch const & batch, bool fromPeer) const {
+    if (mailbox) {
+	for (auto const & pair: batch) {
+	    mailbox->put(pair.first.c_str(), pair.second.c_str(), fromPeer);
+	}
+    } else if (observeBatch) {
+	observeBatch(batch, fromPeer);
+    } else {
+	for (auto const & pair: batch) {
+	    observe(pair.first.c_str(), pair.second.c_str(), fromPeer);
+	}
+    }
+}
+
+KeyValueBroker::Source::Source(
+    KeyValueBroker &	keyValueBroker_,
+    char const *	key_,
+    Get &&		get_)
+:
+    keyValueBroker	(keyValueBroker_),
+    key			(key_),
+    id			(keyValueBroker.intern(key)),
+    get			(std::move(get_))
+{
+    keyValueBroker.addSource(*this);
+}
+
+KeyValueBroker::Source::~Source() {
+    keyValueBroker.removeSource(*this);
+}
+
+std::string KeyValueBroker::Source::operator() () const {
+    return get();
 }
@@ -1,25 +1,108 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "asio.hpp"
+
+/// A KeyValueBroker brokers the values published for keys to their observers.
+/// Keys are interned as small integer Ids (the first time they are seen)
+/// and everything about a key is kept in a deque indexed by its Id
+/// so that publishing the value of a known key
+/// does no string allocation or tree walk.
+/// Entries are never moved (as interning grows the deque)
+/// so what refers to them (like keyOf) stays valid.
 class KeyValueBroker {
 public:
+    using Id = std::size_t;
+
+    /// A Batch of key, value pairs is published together
+    using Batch = std::vector<std::pair<std::string, std::string>>;
+
+    /// A Mailbox is how an asynchronous observer is notified.
+    /// What is put in it (by a publisher, under the broker's lock)
+    /// is delivered, in order, from the subscriber's asio::io_context
+    /// so that a slow subscriber does not stall publishers.
+    /// A letter for a key that is still pending is replaced
+    /// by a newer one, in place (the last value wins),
+    /// so that there is at most one pending letter for each key
+    /// however fast its values are published.
+    /// A letter is never dropped (a dropped value would never be
+    /// observed) and none need be: with one letter per interned key,
+    /// a Mailbox is bounded by the number of keys.
+    /// Replaced letters are counted here
+    /// and for the broker as a whole.
+    class Mailbox : public std::enable_shared_from_this<Mailbox> {
+    public:
+
+	struct Letter {
+	    std::string	key;
+	    std::string	value;
+	    bool	fromPeer;
+	};
+
+	using Deliver = std::function<void(std::vector<Letter> const &)>;
+
+    private:
+	KeyValueBroker &	keyValueBroker;
+	asio::io_context &	io;
+	Deliver const		deliver;
+	std::mutex mutable	mutex;		///< of letters and counts
+	std::vector<Letter>	letters;
+	unsigned		coalesced_;
+	std::atomic<bool>	closed;
+
+	void drain();
+
+    public:
+	Mailbox(
+	    KeyValueBroker &	keyValueBroker,
+	    asio::io_context &	io,
+	    Deliver &&		deliver);
+
+	void put(char const * key, char const * value, bool fromPeer);
+
+	/// deliver nothing more.
+	/// this does not wait for a delivery in progress (no lock is held
+	/// while delivering) so it should be called from io,
+	/// where none can be, as the destructor of an observer is.
+	/// a drain that is still posted holds this Mailbox
+	/// (not what it delivers to) and does nothing.
+	void close();
+
+	unsigned coalesced() const;
+    };
+
     class Observer {
     public:
 	using Observe = std::function<void(char const *)>;
 
-	KeyValueBroker &	keyValueBroker;
-	char const * const	key;
-	char const * const	defaultValue;
-	Observe const		observe;
+	KeyValueBroker &		keyValueBroker;
+	char const * const		key;
+	Id const			id;
+	char const * const		defaultValue;
+	Observe const			observe;
+	std::shared_ptr<Mailbox> const	mailbox;	///< if asynchronous
+
+	/// observe from the publisher's thread
+	Observer(
+	    KeyValueBroker &	keyValueBroker,
+	    char const *	key,
+	    char const *	defaultValue,
+	    Observe &&		observe);
 
+	/// observe from io (where this should also be destroyed)
 	Observer(
 	    KeyValueBroker &	keyValueBroker,
 	    char const *	key,
 	    char const *	defaultValue,
+	    asio::io_context &	io,
 	    Observe &&		observe);
 
 	void operator()(char const * value) const;
@@ -31,20 +114,72 @@ public:
     class GeneralObserver {
     public:
 	using Observe = std::function<void(char const *, char const *, bool)>;
+	using ObserveBatch = std::function<void(Batch const &, bool)>;
 
-	KeyValueBroker &	keyValueBroker;
-	Observe const		observe;
+	KeyValueBroker &		keyValueBroker;
+	Observe const			observe;
+	ObserveBatch const		observeBatch;
+	std::shared_ptr<Mailbox> const	mailbox;	///< if asynchronous
 
+	/// observe from the publisher's thread.
+	/// without observeBatch, each pair of a published batch
+	/// is observed on its own
 	GeneralObserver(
 	    KeyValueBroker &	keyValueBroker,
-	    Observe &&		observe);
+	    Observe &&		observe,
+	    ObserveBatch &&	observeBatch = nullptr);
+
+	/// observe from io (where this should also be destroyed).
+	/// with observeBatch, everything delivered together
+	/// (from the same source) is observed as one batch.
+	GeneralObserver(
+	    KeyValueBroker &	keyValueBroker,
+	    asio::io_context &	io,
+	    Observe &&		observe,
+	    ObserveBatch &&	observeBatch = nullptr);
 
 	void operator()(char const *, char const *, bool = false) const;
+	void operator()(Batch const &, bool = false) const;
 
 	~GeneralObserver();
     };
     friend class Observer;
 
+    /// A Source provides the value of a read-only key when it is asked for.
+    /// Such a value is never set (cached, stored or published)
+    /// and may not be published by anyone else
+    /// but it is included in what serialize() returns.
+    class Source {
+    public:
+	using Get = std::function<std::string()>;
+
+	KeyValueBroker &	keyValueBroker;
+	char const * const	key;
+	Id const		id;
+	Get const		get;
+
+	Source(
+	    KeyValueBroker &	keyValueBroker,
+	    char const *	key,
+	    Get &&		get);
+
+	std::string operator()() const;
+
+	~Source();
+    };
+    friend class Source;
+
+    /// A Snapshot is an immutable copy of all published values
+    /// (not those of Sources) and their serialization.
+    /// It is shared by those that get it and reclaimed when they are done.
+    class Snapshot {
+    public:
+	Batch const		values;	///< sorted by key
+	std::string const	json;
+
+	Snapshot(Batch && values);
+    };
+
     KeyValueBroker(char const * name);
 
     virtual ~KeyValueBroker();
@@ -54,8 +189,28 @@ public:
 	char const *	value,
 	bool		fromPeer = false);
 
+    /// publish all values of the batch at once.
+    /// they are all set (and committed once) before any are observed
+    /// and each GeneralObserver observes those that changed together.
+    void publish(
+	Batch const &	batch,
+	bool		fromPeer = false);
+
     static std::string serialize(char const * key, char const * value);
+    static std::string serialize(Batch const & batch);
+
+    /// make all published values durable now (if they are not already)
+    virtual void flush();
+
+    /// the current Snapshot.
+    /// it is only remade (under lock) if something was set since.
+    std::shared_ptr<Snapshot const> snapshot();
 
+    /// letters replaced by all Mailboxes
+    unsigned coalesced() const {return coalesced_;}
+
+    /// JSON of all values:
+    /// that of the current Snapshot with the values of Sources spliced in.
     std::string serialize();
     std::string serializeDefault();
 
@@ -63,21 +218,49 @@ protected:
     char const * const name;
 
     // return true if new/different value was set
-    virtual bool set(char const * key, char const * value);
+    virtual bool set(Id id, char const * value);
 
     // return true (with value) if we could get it
-    virtual bool get(char const * key, std::string & value);
+    virtual bool get(Id id, std::string & value);
+
+    // make what was set so far durable (now or soon)
+    virtual void commit();
+
+    // the key interned as id (valid for the life of the broker)
+    char const * keyOf(Id id) const {return entries[id].key.c_str();}
 
 private:
-    std::recursive_mutex mutex;
-    using Observers = std::set<Observer const *>;
-    std::map<std::string, Observers *> observersFor;
-    std::set<GeneralObserver const *> generalObservers;
-    std::map<std::string, std::string> valueFor;
-    std::map<std::string, std::string> defaultValueFor;
+    struct Entry {
+	std::string			key;
+	bool				valued;
+	std::string			value;
+	bool				defaulted;
+	std::string			defaultValue;
+	std::vector<Observer const *>	observers;
+	Source const *			source;
+	Entry(char const * key);
+    };
+
+    std::recursive_mutex		mutex;
+    std::deque<Entry>			entries;	// [Id], never moved
+    std::vector<Id>			index;		///< sorted by key
+    std::vector<GeneralObserver const *>	generalObservers;
+    std::shared_ptr<Snapshot const>	snapshot_;	///< atomic access only
+    std::atomic<bool>			stale;		///< snapshot_
+    std::vector<Source const *>		sources;
+    std::atomic<unsigned>		sourceCount;	///< sources.size()
+    std::atomic<unsigned>		coalesced_;
+
+    /// the Id interned for key, if any (otherwise, entries.size())
+    Id find(char const * key) const;
+
+    /// the Id interned for key (now, if not before)
+    Id intern(char const * key);
 
     void subscribe(Observer const & observer);
     void unsubscribe(Observer const & observer);
     void generalSubscribe(GeneralObserver const & generalObserver);
     void generalUnsubscribe(GeneralObserver const & generalObserver);
+    void addSource(Source const & source);
+    void removeSource(Source const & source);
 };
@@ -1,40 +1,249 @@
+#include <algorithm>
 #include <memory>
+#include <utility>
+
+#include "esp_log.h"
+#include "esp_system.h"
 
 #include "Error.h"
 #include "NVSKeyValueBroker.h"
 
-NVSKeyValueBroker::NVSKeyValueBroker(char const * name_)
+// the instance to flush on esp_restart
+// (a shutdown handler is called without an argument)
+static NVSKeyValueBroker * shutdownInstance {nullptr};
+
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+// the blob is a version byte followed by
+// a null terminated key and value for each stored value.
+// the key is not one that could be published.
+static char const * const blobKey {"\x01" "blob"};
+static char constexpr blobVersion {1};
+#endif
+
+/* static */ void NVSKeyValueBroker::flushThat(void * that_) {
+    // from the esp_timer task, only schedule the flush on our flushTask
+    NVSKeyValueBroker * const that {static_cast<NVSKeyValueBroker *>(that_)};
+    that->flushTask.io.post([that](){that->flush();});
+}
+
+/* static */ void NVSKeyValueBroker::flushOnShutdown() {
+    if (shutdownInstance) shutdownInstance->flush();
+}
+
+NVSKeyValueBroker::NVSKeyValueBroker(
+    char const *	name_,
+    unsigned		quietMilliseconds,
+    unsigned		latestMilliseconds,
+    std::size_t		dirtyMax_)
 :
     KeyValueBroker	(name_),
     nvs			([this](){
 	    nvs_handle result;
 	    Error::throwIf(nvs_open(name, NVS_READWRITE, &result));
 	    return result;
+	}()),
+    quiet		(quietMilliseconds * 1000ull),
+    latest		(latestMilliseconds * 1000ll),
+    dirtyMax		(dirtyMax_),
+    flushMutex		(),
+    dirtyMutex		(),
+    values		(),
+    dirty		(),
+    dirtied		(0),
+    flushTask		{"nvsFlush", 1, 4096},
+    timer		([this](){
+	    esp_timer_create_args_t args {};
+	    args.callback		= flushThat;
+	    args.arg			= this;
+	    args.dispatch_method	= ESP_TIMER_TASK;
+	    args.name			= name;
+	    esp_timer_handle_t result;
+	    Error::throwIf(esp_timer_create(&args, &result));
+	    return result;
 	}())
-{}
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    ,
+    stored		(),
+    migrated		()
+#endif
+{
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    size_t length;
+    if (ESP_OK == nvs_get_blob(nvs, blobKey, nullptr, &length)) {
+	std::unique_ptr<char[]> blob(new char[length]);
+	Error::throwIf(nvs_get_blob(nvs, blobKey, blob.get(), &length));
+	char const * const end = blob.get() + length;
+	char const * it = blob.get();
+	if (length && blobVersion == *it++) {
+	    while (it < end) {
+		char const * const key = it;
+		char const * const keyEnd = std::find(key, end, 0);
+		if (keyEnd == end) break;
+		char const * const value = keyEnd + 1;
+		char const * const valueEnd = std::find(value, end, 0);
+		if (valueEnd == end) break;
+		stored.emplace(std::string(key, keyEnd),
+		    std::string(value, valueEnd));
+		it = valueEnd + 1;
+	    }
+	}
+	if (it != end) {
+	    ESP_LOGE(name, "blob malformed");
+	}
+	ESP_LOGI(name, "blob %u values", static_cast<unsigned>(stored.size()));
+    }
+#endif
+    dirty.reserve(dirtyMax);
+    flushTask.start();
+    shutdownInstance = this;
+    esp_register_shutdown_handler(flushOnShutdown);
+}
 
-/* virtual */ bool NVSKeyValueBroker::set(char const * key, char const * value) {
+void NVSKeyValueBroker::setDirty(Id id, char const * value) {
+    // called with dirtyMutex held.
+    // value storage is reused so this will not allocate once warm
+    if (values.size() <= id) values.resize(id + 1);
+    Value & entry = values[id];
+    if (!entry.key) entry.key = keyOf(id);
+    entry.value = value;
+    if (!entry.dirty) {
+	entry.dirty = true;
+	if (dirty.empty()) {
+	    dirtied = esp_timer_get_time();
+	}
+	dirty.push_back(id);
+    }
+}
+
+/* virtual */ bool NVSKeyValueBroker::set(Id id, char const * value) {
     // cache this
-    if (KeyValueBroker::set(key, value)) {
-	// store this
-	nvs_set_str(nvs, key, value);
-	nvs_commit(nvs);
+    if (KeyValueBroker::set(id, value)) {
+	// store this, later
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	setDirty(id, value);
 	return true;
     }
     return false;
 }
 
-/* virtual */ bool NVSKeyValueBroker::get(char const * key, std::string & value) {
+/* virtual */ void NVSKeyValueBroker::commit() {
+    // (re)schedule a flush for when publishing has been quiet
+    // but no later than latest after the first dirty value
+    {
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	if (dirty.empty()) return;
+	if (dirty.size() < dirtyMax) {
+	    int64_t const left {dirtied + latest - esp_timer_get_time()};
+	    if (0 < left) {
+		esp_timer_stop(timer);
+		esp_timer_start_once(timer,
+		    std::min(quiet, static_cast<uint64_t>(left)));
+		return;
+	    }
+	}
+    }
+    flushTask.io.post([this](){flush();});
+}
+
+/* virtual */ void NVSKeyValueBroker::flush() {
+    // take what is dirty now and write it without holding dirtyMutex
+    // so that values may be set (and dirtied again) meanwhile
+    std::lock_guard<std::mutex> flushLock(flushMutex);
+    esp_timer_stop(timer);
+    std::vector<Id> flushing;
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    std::string blob(1, blobVersion);
+    std::size_t erasing;
+#else
+    std::vector<std::pair<char const *, std::string>> writing;
+#endif
+    {
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	if (dirty.empty()) return;
+	flushing.swap(dirty);
+	dirty.reserve(dirtyMax);
+	for (auto id: flushing) {
+	    Value & entry = values[id];
+	    entry.dirty = false;
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+	    stored[entry.key] = entry.value;
+#else
+	    writing.emplace_back(entry.key, entry.value);
+#endif
+	}
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+	for (auto const & pair: stored) {
+	    blob.append(pair.first.c_str(), pair.first.size() + 1);
+	    blob.append(pair.second.c_str(), pair.second.size() + 1);
+	}
+	erasing = migrated.size();
+#endif
+    }
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    esp_err_t const e {nvs_set_blob(nvs, blobKey, blob.data(), blob.size())};
+    if (ESP_OK != e) {
+	// keep migrated values where they are (and dirty) and try again later
+	ESP_LOGE(name, "flush blob %s (0x%x)", esp_err_to_name(e), e);
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	for (auto id: flushing) {
+	    Value & entry = values[id];
+	    if (!entry.dirty) {
+		entry.dirty = true;
+		dirty.push_back(id);
+	    }
+	}
+	return;
+    }
+    {
+	// only those migrated before the blob was built may be erased
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	for (std::size_t i {0}; i < erasing; ++i) {
+	    nvs_erase_key(nvs, migrated[i].c_str());
+	}
+	migrated.erase(migrated.begin(), migrated.begin() + erasing);
+    }
+#else
+    for (auto const & pair: writing) {
+	nvs_set_str(nvs, pair.first, pair.second.c_str());
+    }
+#endif
+    nvs_commit(nvs);
+    ESP_LOGI(name, "flush %u", static_cast<unsigned>(flushing.size()));
+}
+
+/* virtual */ bool NVSKeyValueBroker::get(Id id, std::string & value) {
     // try our cache
-    if (KeyValueBroker::get(key, value)) return true;
+    if (KeyValueBroker::get(id, value)) return true;
+    char const * const key = keyOf(id);
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    {
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	auto it = stored.find(key);
+	if (it != stored.end()) {
+	    // cache this
+	    KeyValueBroker::set(id, it->second.c_str());
+	    value = it->second;
+	    return true;
+	}
+    }
+#endif
     try {
 	size_t length;
 	Error::throwIf(nvs_get_str(nvs, key, nullptr, &length));
-	std::unique_ptr<char> copy(new char[length]);
+	std::unique_ptr<char[]> copy(new char[length]);
 	Error::throwIf(nvs_get_str(nvs, key, copy.get(), &length));
 	// cache this
-	KeyValueBroker::set(key, copy.get());
+	KeyValueBroker::set(id, copy.get());
 	value = copy.get();
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+	// migrate this to the blob
+	{
+	    std::lock_guard<std::mutex> lock(dirtyMutex);
+	    setDirty(id, copy.get());
+	    migrated.push_back(key);
+	}
+	commit();
+#endif
     } catch (esp_err_t & e) {
 	if (ESP_ERR_NVS_NOT_FOUND == e) return false;
 	throw;
@@ -43,5 +252,11 @@ NVSKeyValueBroker::NVSKeyValueBroker(char const * name_)
 }
 
 NVSKeyValueBroker::~NVSKeyValueBroker() {
+    esp_unregister_shutdown_handler(flushOnShutdown);
+    shutdownInstance = nullptr;
+    esp_timer_stop(timer);
+    flushTask.stop();
+    flush();
+    esp_timer_delete(timer);
     nvs_close(nvs);
 }
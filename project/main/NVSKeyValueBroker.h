@@ -1,20 +1,79 @@
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "esp_timer.h"
 #include "nvs.h"
+#include "sdkconfig.h"
 
 #include "KeyValueBroker.h"
+#include "WorkTask.h"
 
+/// An NVSKeyValueBroker is a KeyValueBroker whose values persist in NVS.
+/// Values are cached and written behind:
+/// a set value is only marked dirty
+/// and all dirty values are written to NVS and committed together
+/// when publishing has been quiet for a while,
+/// a while after the first was marked
+/// or when too many are dirty (whichever comes first)
+/// so that a burst of publishing (dragging a slider)
+/// does not stall its publisher or wear the flash with a commit each.
+/// The esp_timer task only schedules a flush;
+/// the flush itself is done on a low priority flushTask of our own
+/// (so that other esp_timer callbacks are not stalled behind NVS writes)
+/// and without holding up those that set values meanwhile.
+/// Dirty values are also flushed on destruction and on esp_restart.
+///
+/// With CONFIG_ARTLIGHT_NVS_BLOB, all values are stored together
+/// in one NVS blob that is read once on construction
+/// (rather than with NVS lookups for each key as it is observed).
+/// Values stored in the older layout (an NVS string for each key)
+/// are migrated to the blob as they are first gotten.
 class NVSKeyValueBroker : public KeyValueBroker {
 private:
-    nvs_handle		nvs;
+    nvs_handle				nvs;
+    uint64_t const			quiet;		///< microseconds
+    int64_t const			latest;		///< microseconds
+    std::size_t const			dirtyMax;
+    /// Value is what is cached for an Id (and whether it is dirty)
+    struct Value {
+	char const *	key	{nullptr};
+	std::string	value;
+	bool		dirty	{false};
+    };
+    std::mutex				flushMutex;	///< one flush at a time
+    std::mutex				dirtyMutex;
+    std::vector<Value>			values;		///< by Id
+    std::vector<Id>			dirty;		///< of values
+    int64_t				dirtied;	///< when first dirty
+    WorkTask				flushTask;
+    esp_timer_handle_t			timer;
+#ifdef CONFIG_ARTLIGHT_NVS_BLOB
+    std::map<std::string, std::string>	stored;		///< value by key
+    std::vector<std::string>		migrated;	///< keys to erase
+#endif
+
+    static void flushThat(void *);
+    static void flushOnShutdown();
+
+    void setDirty(Id id, char const * value);
 
 protected:
-    virtual bool set(char const * key, char const * value);
-    virtual bool get(char const * key, std::string & value);
+    virtual bool set(Id id, char const * value);
+    virtual bool get(Id id, std::string & value);
+    virtual void commit();
 
 public:
-    NVSKeyValueBroker(char const * name);
+    NVSKeyValueBroker(
+	char const *	name,
+	unsigned	quietMilliseconds	= 1000,
+	unsigned	latestMilliseconds	= 5000,
+	std::size_t	dirtyMax		= 32);
+
+    virtual void flush();
+
     ~NVSKeyValueBroker();
 };
@@ -14,7 +14,6 @@ extern "C" {
 #include "Curve.h"
 #include "NixieArtTask.h"
 #include "TSL2591LuxSensor.h"
-#include "Timer.h"
 #include "fromString.h"
 
 using APA102::LED;
@@ -212,6 +211,8 @@ static float fade(float high, float dim, float min, float from) {
 }
 
 void NixieArtTask::update_() {
+    FrameStats::Scope frameScope {frameStats, FrameStats::render};
+
     // construct the default (off) LED and nixie image
     APA102::Message<ledCount> ledMessage;
     PCA9685::Pwm pca9685Pwms[pca9685s.size()][PCA9685::pwmCount];
@@ -455,15 +456,20 @@ void NixieArtTask::update_() {
     }
 
     // show the image
+    bool const unchanged_ {unchanged(ledMessage)};
+    frameScope.next(FrameStats::spiWait);
 
     // SPI::Transaction constructor queues the ledMessage.
     // SPI::Transaction destructor waits for result.
-    {
+    if (unchanged_) {
+	frameStats.count(FrameStats::unchanged);
+    } else {
 	SPI::Transaction transaction(spiDevice, SPI::Transaction::Config()
 	    .tx_buffer_(&ledMessage)
 	    .length_(ledMessage.length()));
     }
 
+    frameScope.next(FrameStats::i2cWrite);
     for (auto & pca9685: pca9685s) {
 	auto const place {&pca9685 - pca9685s.data()};
 	pca9685.setPwms(0, pca9685Pwms[place], PCA9685::pwmCount, true);
@@ -471,18 +477,9 @@ void NixieArtTask::update_() {
 }
 
 void NixieArtTask::update() {
-    // if the rate at which we complete work
-    // is less than the periodic demand for such work
-    // the work queue will eventually exhaust all memory.
-    if (updated++) {
-	// catch up to the rate of demand
-	ESP_LOGW(name, "update rate too fast. %u", updated - 1);
-	return;
-    }
+    frameStats.started();
     update_();
-    // ignore any queued update work
-    io.poll();
-    updated = 0;
+    frameScheduler.done();
 }
 
 static PCA9685::Mode const pca9685Mode {
@@ -718,7 +715,14 @@ NixieArtTask::NixieArtTask(
 	    });
 	}),
 
-    updated(0)
+    frameStats(keyValueBroker),
+    unchanged(CONFIG_ARTLIGHT_APA102_REFRESH),
+    frameScheduler(name, 25.0f, [this](){
+	frameStats.expired();
+	io.post([this](){
+	    this->update();
+	});
+    })
 {
     if (motionSensor) {
 	motionSensor->setConfiguration0(motionSensor->getConfiguration0()
@@ -746,15 +750,7 @@ void NixieArtTask::run() {
     // the tubes should be powered off now, wait 1000ms before powering them on.
     vTaskDelay(1000 / portTICK_PERIOD_MS);
 
-    // asio timers are not supported
-    // adapt a FreeRTOS timer to post timeout to this task.
-    Timer updateTimer(name, 4, true, [this](){
-	io.post([this](){
-	    this->update();
-	});
-    });
-
-    updateTimer.start();
+    frameScheduler.start();
 
     // create some dummy work ...
     asio::io_service::work work(io);
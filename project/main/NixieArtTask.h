@@ -4,6 +4,8 @@
 
 #include "APA102.h"
 #include "AsioTask.h"
+#include "FrameScheduler.h"
+#include "FrameStats.h"
 #include "HT7M2xxxMotionSensor.h"
 #include "I2C.h"
 #include "KeyValueBroker.h"
@@ -68,7 +70,9 @@ protected:
     void run() override;
 
 private:
-    unsigned updated;
+    FrameStats frameStats;
+    APA102::Unchanged unchanged;
+    FrameScheduler frameScheduler;
     void update_();
     void update();
 
@@ -51,6 +51,7 @@ void OtaTask::update() {
     config.cert_pem = certificate.c_str();
     if (ESP_OK == esp_https_ota(&config)) {
 	ESP_LOGI(name, "restart");
+	keyValueBroker.flush();
 	esp_restart();
     }
 }
@@ -6,6 +6,21 @@
 #include "fromString.h"
 #include "PeerTask.h"
 
+void PeerTask::send(char * message, size_t size) {
+    peer.async_send_to(asio::buffer(message, size),
+	sendEndpoint,
+	[this, message](std::error_code error, std::size_t){
+	    if (error) {
+		ESP_LOGE(name, "send error: %s",
+		    error.message().c_str());
+	    } else {
+		ESP_LOGI(name, "send %s %s",
+		    message, message + strlen(message) + 1);
+	    }
+	    delete[] message;
+	});
+}
+
 void PeerTask::receive() {
     peer.async_receive_from(
 	asio::buffer(receiveMessage, sizeof receiveMessage - 1),
@@ -21,14 +36,30 @@ void PeerTask::receive() {
 		    ESP_LOGE(name, "receive bad length");
 		} else {
 		    receiveMessage[length] = 0;
-		    char const * key = receiveMessage;
-		    size_t keySize = strlen(key) + 1;
-		    char const * value = key + keySize;
-		    if (length != keySize + strlen(value) + 1) {
+		    char const * end = receiveMessage + length;
+		    KeyValueBroker::Batch batch;
+		    char const * pair = receiveMessage;
+		    while (pair < end) {
+			char const * key = pair;
+			size_t keySize = strlen(key) + 1;
+			char const * value = key + keySize;
+			if (!(value < end)) break;
+			size_t valueSize = strlen(value) + 1;
+			if (value + valueSize > end) break;
+			batch.emplace_back(key, value);
+			pair = value + valueSize;
+		    }
+		    if (pair != end) {
 			ESP_LOGE(name, "receive bad message");
+		    } else if (1 == batch.size()) {
+			ESP_LOGI(name, "receive %s %s",
+			    batch[0].first.c_str(), batch[0].second.c_str());
+			keyValueBroker.publish(
+			    batch[0].first.c_str(), batch[0].second.c_str(), true);
 		    } else {
-			ESP_LOGI(name, "receive %s %s", key, value);
-			keyValueBroker.publish(key, value, true);
+			ESP_LOGI(name, "receive batch of %u",
+			    static_cast<unsigned>(batch.size()));
+			keyValueBroker.publish(batch, true);
 		    }
 		}
 	    }
@@ -60,7 +91,8 @@ PeerTask::PeerTask(
 	    }
 	}),
 
-    generalObserver	(keyValueBroker,
+    // observe (and send) from our io
+    generalObserver	(keyValueBroker, io,
 	[this](char const * key, char const * value, bool fromPeer) {
 	    // keys that start with an underscore are not for our peers
 	    if (!fromPeer && '_' != *key && sendEndpoint.port()) {
@@ -69,20 +101,7 @@ PeerTask::PeerTask(
 		char * message = new char[messageSize];
 		std::strcpy(message, key);
 		std::strcpy(message + keySize, value);
-		io.post([this, message, messageSize](){
-		    peer.async_send_to(asio::buffer(message, messageSize),
-			sendEndpoint,
-			[this, message](std::error_code error, std::size_t){
-			    if (error) {
-				ESP_LOGE(name, "send error: %s",
-				    error.message().c_str());
-			    } else {
-				ESP_LOGI(name, "send %s %s",
-				    message, message + strlen(message) + 1);
-			    }
-			    delete message;
-			});
-		});
+		send(message, messageSize);
 	    }
 	}),
 
@@ -13,9 +13,16 @@ private:
     KeyValueBroker::Observer		portObserver;
     KeyValueBroker::GeneralObserver	generalObserver;
 
-    char				receiveMessage[128];
+    /// a message is a datagram of a key, value pair
+    /// (each a null terminated string) that must fit here.
+    /// we send only this single pair form, which all peers understand,
+    /// but we accept (and publish as a batch) more pairs in one message.
+    char				receiveMessage[512];
     asio::ip::udp::endpoint		receiveEndpoint;
 
+    /// send (and delete) size bytes of message (from our io)
+    void send(char * message, size_t size);
+
     void receive();
 public:
 
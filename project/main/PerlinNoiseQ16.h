@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+/// PerlinNoiseQ16 has the same interface as PerlinNoise (PerlinNoise.hpp)
+/// but evaluates the noise with Q16.16 fixed point integer arithmetic
+/// instead of float.
+/// Given the same seed (or the same random number generator state)
+/// it is seeded with the same permutation
+/// so either may be chosen at a call site for the same noise.
+///
+/// Float inputs are converted to Q16.16 (truncated to 1/65536)
+/// and must be in [-32768, 32768).
+/// Noise is periodic (256) so larger values should be reduced first.
+/// As the integer (lattice) part of a Q16.16 value wraps modulo 65536,
+/// a multiple of this period, octaves may double coordinates
+/// without overflow concerns.
+///
+/// Measured against PerlinNoise over uniformly distributed inputs in
+/// [-2, 258), the absolute noise error is less than
+/// 1e-4 (1D), 2e-4 (2D), 2.5e-4 (3D) and 3e-4 (3D, 4 octaves).
+/// noise0_1 errors are half of these.
+/// All are well below 1/4096 (12 bit LED resolution).
+/// This error comes from input truncation, the rounding of
+/// each fixed point product and the float precision of PerlinNoise itself.
+class PerlinNoiseQ16 {
+public:
+    using Q16 = std::int32_t;
+    static Q16 constexpr one {1 << 16};
+
+    static Q16 toQ16(float f) {return static_cast<Q16>(f * one);}
+    static float fromQ16(Q16 q) {return q * (1.0f / one);}
+
+private:
+    std::uint8_t p[512];
+
+    static Q16 multiply(Q16 a, Q16 b) {
+	return static_cast<Q16>((static_cast<std::int64_t>(a) * b + (1 << 15)) >> 16);
+    }
+
+    // t * t * t * (t * (t * 6 - 15) + 10) for t in [0, 1)
+    static Q16 fade(Q16 t) {
+	return multiply(multiply(multiply(t, t), t),
+	    multiply(t, 6 * t - 15 * one) + 10 * one);
+    }
+
+    static Q16 lerp(Q16 t, Q16 a, Q16 b) {
+	return a + multiply(t, b - a);
+    }
+
+    static Q16 grad(std::uint8_t hash, Q16 x, Q16 y, Q16 z) {
+	unsigned const h = hash & 15;
+	Q16 const u = h < 8 ? x : y;
+	Q16 const v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+	return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+    }
+
+    template <typename Shuffle> void reseed_(Shuffle shuffle) {
+	// shuffle as PerlinNoise does (with int32_t values)
+	// so that the same random numbers are consumed
+	std::int32_t q[256];
+	for (std::size_t i = 0; i < 256; ++i) {
+	    q[i] = i;
+	}
+	shuffle(q);
+	for (std::size_t i = 0; i < 256; ++i) {
+	    p[256 + i] = p[i] = q[i];
+	}
+    }
+
+public:
+    PerlinNoiseQ16(std::uint32_t seed = std::default_random_engine::default_seed) {
+	reseed(seed);
+    }
+
+    template <class URNG> PerlinNoiseQ16(URNG & urng) {
+	reseed(urng);
+    }
+
+    void reseed(std::uint32_t seed) {
+	reseed_([seed](std::int32_t (&q)[256]) {
+	    std::shuffle(std::begin(q), std::end(q),
+		std::default_random_engine(seed));
+	});
+    }
+
+    template <class URNG> void reseed(URNG & urng) {
+	reseed_([&urng](std::int32_t (&q)[256]) {
+	    std::shuffle(std::begin(q), std::end(q), urng);
+	});
+    }
+
+    /// A Cell is what is needed from a Q16.16 point
+    /// to evaluate any permutation's noise there:
+    /// its lattice cell, offsets into it and their fades.
+    struct Cell {
+	unsigned	X, Y, Z;
+	Q16		x, y, z;
+	Q16		u, v, w;
+	Cell(Q16 x_, Q16 y_, Q16 z_) :
+	    X((x_ >> 16) & 255), Y((y_ >> 16) & 255), Z((z_ >> 16) & 255),
+	    x(x_ & (one - 1)), y(y_ & (one - 1)), z(z_ & (one - 1)),
+	    u(fade(x)), v(fade(y)), w(fade(z))
+	{}
+	Cell() = default;
+    };
+
+    /// noise in Q16.16 [-1, 1] in a Cell
+    Q16 noiseQ16(Cell const & cell) const {
+	unsigned const X = cell.X, Y = cell.Y, Z = cell.Z;
+	Q16 const x = cell.x, y = cell.y, z = cell.z;
+	Q16 const u = cell.u, v = cell.v, w = cell.w;
+
+	unsigned const A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+	unsigned const B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+
+	return lerp(w, lerp(v, lerp(u, grad(p[AA], x, y, z),
+	    grad(p[BA], x - one, y, z)),
+	    lerp(u, grad(p[AB], x, y - one, z),
+	    grad(p[BB], x - one, y - one, z))),
+	    lerp(v, lerp(u, grad(p[AA + 1], x, y, z - one),
+	    grad(p[BA + 1], x - one, y, z - one)),
+	    lerp(u, grad(p[AB + 1], x, y - one, z - one),
+	    grad(p[BB + 1], x - one, y - one, z - one))));
+    }
+
+    /// noise in Q16.16 [-1, 1] from Q16.16 coordinates
+    Q16 noiseQ16(Q16 x, Q16 y, Q16 z) const {
+	return noiseQ16(Cell(x, y, z));
+    }
+
+    /// octaves of noise in Q16.16 from Q16.16 coordinates
+    Q16 octaveNoiseQ16(Q16 x, Q16 y, Q16 z, std::int32_t octaves) const {
+	Q16 result = 0;
+	for (std::int32_t i = 0; i < octaves; ++i) {
+	    result += noiseQ16(x, y, z) >> i;
+	    // double, modulo 65536 (a multiple of the period)
+	    x = static_cast<Q16>(static_cast<std::uint32_t>(x) << 1);
+	    y = static_cast<Q16>(static_cast<std::uint32_t>(y) << 1);
+	    z = static_cast<Q16>(static_cast<std::uint32_t>(z) << 1);
+	}
+	return result;
+    }
+
+    float noise(float x) const {
+	return noise(x, 0.0f, 0.0f);
+    }
+
+    float noise(float x, float y) const {
+	return noise(x, y, 0.0f);
+    }
+
+    float noise(float x, float y, float z) const {
+	return fromQ16(noiseQ16(toQ16(x), toQ16(y), toQ16(z)));
+    }
+
+    float octaveNoise(float x, std::int32_t octaves) const {
+	return octaveNoise(x, 0.0f, 0.0f, octaves);
+    }
+
+    float octaveNoise(float x, float y, std::int32_t octaves) const {
+	return octaveNoise(x, y, 0.0f, octaves);
+    }
+
+    float octaveNoise(float x, float y, float z, std::int32_t octaves) const {
+	return fromQ16(octaveNoiseQ16(toQ16(x), toQ16(y), toQ16(z), octaves));
+    }
+
+    float noise0_1(float x) const {
+	return noise(x) * 0.5f + 0.5f;
+    }
+
+    float noise0_1(float x, float y) const {
+	return noise(x, y) * 0.5f + 0.5f;
+    }
+
+    float noise0_1(float x, float y, float z) const {
+	return noise(x, y, z) * 0.5f + 0.5f;
+    }
+
+    float octaveNoise0_1(float x, std::int32_t octaves) const {
+	return octaveNoise(x, octaves) * 0.5f + 0.5f;
+    }
+
+    float octaveNoise0_1(float x, float y, std::int32_t octaves) const {
+	return octaveNoise(x, y, octaves) * 0.5f + 0.5f;
+    }
+
+    float octaveNoise0_1(float x, float y, float z, std::int32_t octaves) const {
+	return octaveNoise(x, y, z, octaves) * 0.5f + 0.5f;
+    }
+
+    /// Evaluate octaveNoise0_1 for each of noiseCount noises
+    /// at each of count points (x[i], y[i], z[i])
+    /// into results[i * noiseCount + n] (for noises[n]).
+    /// The Cell of each point is computed once for all noises.
+    /// Points are processed in chunks with simple loops over
+    /// contiguous arrays so that the compiler may vectorize the
+    /// coordinate conversions, fades and result conversions.
+    static void octaveNoise0_1(
+	PerlinNoiseQ16 const * const *	noises,
+	std::size_t			noiseCount,
+	std::size_t			count,
+	float const *			x,
+	float const *			y,
+	float const *			z,
+	float *				results,
+	std::int32_t			octaves = 1)
+    {
+	std::size_t constexpr chunk {32};
+	for (std::size_t begin = 0; begin < count; begin += chunk) {
+	    std::size_t const size = std::min(chunk, count - begin);
+	    Q16 qx[chunk], qy[chunk], qz[chunk];
+	    for (std::size_t i = 0; i < size; ++i) {
+		qx[i] = toQ16(x[begin + i]);
+		qy[i] = toQ16(y[begin + i]);
+		qz[i] = toQ16(z[begin + i]);
+	    }
+	    float * const result = results + begin * noiseCount;
+	    for (std::size_t n = 0; n < noiseCount; ++n) {
+		for (std::size_t i = 0; i < size; ++i) {
+		    result[i * noiseCount + n] = 0.0f;
+		}
+	    }
+	    for (std::int32_t o = 0; o < octaves; ++o) {
+		Cell cell[chunk];
+		for (std::size_t i = 0; i < size; ++i) {
+		    cell[i] = Cell(qx[i], qy[i], qz[i]);
+		    // double, modulo 65536 (a multiple of the period)
+		    qx[i] = static_cast<Q16>(static_cast<std::uint32_t>(qx[i]) << 1);
+		    qy[i] = static_cast<Q16>(static_cast<std::uint32_t>(qy[i]) << 1);
+		    qz[i] = static_cast<Q16>(static_cast<std::uint32_t>(qz[i]) << 1);
+		}
+		float const amp = 1.0f / (1 << o);
+		for (std::size_t n = 0; n < noiseCount; ++n) {
+		    PerlinNoiseQ16 const & noise = *noises[n];
+		    for (std::size_t i = 0; i < size; ++i) {
+			result[i * noiseCount + n]
+			    += fromQ16(noise.noiseQ16(cell[i])) * amp;
+		    }
+		}
+	    }
+	    for (std::size_t i = 0; i < size * noiseCount; ++i) {
+		result[i] = result[i] * 0.5f + 0.5f;
+	    }
+	}
+    }
+};
@@ -0,0 +1,161 @@
+#include "esp_log.h"
+
+#include "fromString.h"
+#include "PixelStream.h"
+
+namespace {
+
+// DDP header (big endian)
+//	0	flags	version (2 bits) ... push (1 bit)
+//	1	sequence number (low 4 bits), 0 if not used
+//	2	data type
+//	3	destination id
+//	4-7	data offset, in bytes
+//	8-9	data length, in bytes
+//	10-13	timecode, if flagged
+size_t constexpr headerSize		{10};
+size_t constexpr timecodeSize		{4};
+uint8_t constexpr versionMask		{0xc0};
+uint8_t constexpr version1		{0x40};
+uint8_t constexpr timecodeFlag		{0x10};
+uint8_t constexpr storageFlag		{0x08};
+uint8_t constexpr replyFlag		{0x04};
+uint8_t constexpr queryFlag		{0x02};
+uint8_t constexpr pushFlag		{0x01};
+uint8_t constexpr sequenceMask		{0x0f};
+uint8_t constexpr typeUndefined		{0x00};
+uint8_t constexpr typeRgb8		{0x0b};	// RGB, 8 bits per pixel element
+uint8_t constexpr typeRgbLegacy		{0x01};	// as sent by some controllers
+uint8_t constexpr destinationDisplay	{0x01};
+uint8_t constexpr destinationAll	{0xff};
+size_t constexpr pixelSize		{3};
+
+}
+
+void PixelStream::received(std::size_t length) {
+    uint8_t const flags {packet[0]};
+    if (headerSize > length
+	    || version1 != (flags & versionMask)
+	    || (flags & (storageFlag | replyFlag | queryFlag))) {
+	frameStats.count(FrameStats::streamErrors);
+	return;
+    }
+    uint8_t const type {packet[2]};
+    uint8_t const destination {packet[3]};
+    uint32_t const offset {static_cast<uint32_t>(packet[4]) << 24
+	| packet[5] << 16 | packet[6] << 8 | packet[7]};
+    std::size_t const dataSize {static_cast<std::size_t>(
+	packet[8] << 8 | packet[9])};
+    std::size_t const dataBegin
+	{headerSize + (flags & timecodeFlag ? timecodeSize : 0)};
+    if (dataBegin + dataSize > length
+	    || (destinationDisplay != destination
+		&& destinationAll != destination)
+	    || (typeRgb8 != type && typeRgbLegacy != type
+		&& typeUndefined != type)
+	    || offset % pixelSize || dataSize % pixelSize) {
+	frameStats.count(FrameStats::streamErrors);
+	return;
+    }
+
+    // sequence numbers cycle through 1 to 15 (0 is not used).
+    // one that is up to half of a cycle behind the last is late.
+    if (unsigned const sequence_ = packet[1] & sequenceMask) {
+	if (sequence) {
+	    unsigned const ahead
+		{(sequence_ + sequenceMask - sequence) % sequenceMask};
+	    if (!ahead || sequenceMask / 2 < ahead) {
+		frameStats.count(FrameStats::streamLates);
+		return;
+	    }
+	    if (1 < ahead) frameStats.count(FrameStats::streamGaps, ahead - 1);
+	}
+	sequence = sequence_;
+    }
+
+    if (dataSize) {
+	write(offset / pixelSize, packet + dataBegin, dataSize / pixelSize);
+    }
+    if (flags & pushFlag) {
+	push();
+    }
+}
+
+void PixelStream::open() {
+    asio::error_code error;
+    socket.close(error);
+    sequence = 0;
+    if (!started || !port) return;
+    socket.open(asio::ip::udp::v4(), error);
+    if (!error) socket.bind(asio::ip::udp::endpoint(
+	asio::ip::udp::v4(), port), error);
+    if (error) {
+	ESP_LOGE(name, "bind error: %s", error.message().c_str());
+	socket.close(error);
+	return;
+    }
+    receive();
+}
+
+void PixelStream::start() {
+    started = true;
+    open();
+}
+
+void PixelStream::stop() {
+    started = false;
+    open();
+}
+
+void PixelStream::receive() {
+    socket.async_receive_from(asio::buffer(packet), endpoint,
+	[this](asio::error_code error, std::size_t length){
+	    if (error) {
+		// aborted when the socket is closed (stopped or rebound)
+		if (asio::error::operation_aborted == error) return;
+		ESP_LOGE(name, "receive error: %s", error.message().c_str());
+		if (asio::error::not_connected == error) return;
+	    } else {
+		received(length);
+	    }
+	    receive();
+	});
+}
+
+PixelStream::PixelStream(
+    char const *	name_,
+    asio::io_context &	io_,
+    KeyValueBroker &	keyValueBroker,
+    char const *	portKey,
+    char const *	portDefault,
+    Write &&		write_,
+    Push &&		push_,
+    FrameStats &	frameStats_)
+:
+    name		(name_),
+    io			(io_),
+    socket		(io),
+    write		(std::move(write_)),
+    push		(std::move(push_)),
+    frameStats		(frameStats_),
+    port		(0),
+    started		(false),
+    portObserver	(keyValueBroker, portKey, portDefault,
+	[this](char const * value){
+	    static unsigned short constexpr min = 1023;	  // privileged max
+	    static unsigned short constexpr max = 0xc000; // ephemeral min
+	    unsigned short port_ = fromString<unsigned short>(value);
+	    if (0 == port_ || (min < port_ && port_ < max)) {
+		io.post([this, port_](){
+		    ESP_LOGI(name, "port %d", static_cast<int>(port_));
+		    port = port_;
+		    open();
+		});
+	    }
+	}),
+
+    packet		{},
+    endpoint		(),
+
+    sequence		(0)
+{}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "asio/ip/udp.hpp"
+
+#include "FrameStats.h"
+#include "KeyValueBroker.h"
+
+/// A PixelStream receives pixels from a show controller as
+/// DDP (Distributed Display Protocol, http://www.3waylabs.com/ddp/)
+/// packets on the UDP port of its KeyValueBroker key.
+/// Only version 1 packets of 8 bit RGB pixels at pixel aligned offsets
+/// are accepted. The pixels of each are handed to write, in place,
+/// and a packet with the push flag set calls push.
+/// Packets that arrive late (their sequence number is behind that of the
+/// last) are dropped. Gaps in sequence numbers are counted
+/// but the packets after them are used.
+/// Gaps, late and malformed packets are counted in frameStats.
+/// Its socket is only open (bound to the port) between start and stop.
+/// Everything happens on the io_context given, which should be the
+/// one that owns what write and push update.
+class PixelStream {
+public:
+    /// write count pixels (3 bytes each: red, green, blue) at rgb
+    /// starting at pixel offset
+    using Write = std::function<void(
+	std::size_t offset, uint8_t const * rgb, std::size_t count)>;
+    using Push = std::function<void()>;
+
+private:
+    char const * const			name;
+    asio::io_context &			io;
+    asio::ip::udp::socket		socket;
+    Write const				write;
+    Push const				push;
+    FrameStats &			frameStats;
+    unsigned short			port;		///< 0 if none
+    bool				started;
+    KeyValueBroker::Observer const	portObserver;
+
+    uint8_t				packet[1500];
+    asio::ip::udp::endpoint		endpoint;
+
+    unsigned				sequence;	///< last, 0 if none
+
+    /// (re)open the socket on port, if started
+    void open();
+
+    void receive();
+    void received(std::size_t length);
+
+public:
+    PixelStream(
+	char const *		name,
+	asio::io_context &	io,
+	KeyValueBroker &	keyValueBroker,
+	char const *		portKey,
+	char const *		portDefault,
+	Write &&		write,
+	Push &&			push,
+	FrameStats &		frameStats);
+
+    /// open the socket and receive packets (call from io)
+    void start();
+
+    /// close the socket (call from io)
+    void stop();
+};
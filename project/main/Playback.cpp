@@ -0,0 +1,24 @@
+#include "Error.h"
+
+#include "Playback.h"
+
+Playback::Map::Map(char const * label) {
+    esp_partition_t const * const partition {esp_partition_find_first(
+	ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label)};
+    if (!partition) throw esp_err_t {ESP_ERR_NOT_FOUND};
+    void const * data_;
+    Error::throwIf(esp_partition_mmap(partition, 0, partition->size,
+	SPI_FLASH_MMAP_DATA, &data_, &handle));
+    data = static_cast<uint8_t const *>(data_);
+    size = partition->size;
+}
+
+Playback::Map::~Map() {
+    spi_flash_munmap(handle);
+}
+
+Playback::Playback(char const * label)
+:
+    map		(label),
+    player	(map.data, map.size)
+{}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "esp_partition.h"
+
+#include "Capture.h"
+
+/// A Playback plays (with its player) the Capture stream of
+/// pre-rendered frames in a flash data partition.
+/// The partition is memory mapped so the stream is decoded from flash
+/// without a copy in RAM.
+class Playback {
+private:
+    /// Playback::Map constructor/destructor wraps
+    /// esp_partition_mmap/spi_flash_munmap
+    struct Map {
+	uint8_t const *		data;
+	std::size_t		size;
+	spi_flash_mmap_handle_t	handle;
+	Map(char const * label);
+	~Map();
+    } const map;
+
+public:
+    Capture::Player player;
+
+    /// Construct a Playback of the data partition labeled label.
+    /// Throw ESP_ERR_NOT_FOUND if there is no such partition.
+    Playback(char const * label);
+};
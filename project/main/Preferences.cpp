@@ -14,6 +14,7 @@ esp_err_t Preferences::get(httpd_req_t * req) {
 
 esp_err_t Preferences::post(httpd_req_t * req) {
     // publish all key, value pairs from form-urlencoded data in body
+    // as one batch
     if (size_t left = req->content_len) {
 	char * end;
 	std::unique_ptr<char> form(end = new char[left + 1]());
@@ -33,6 +34,7 @@ esp_err_t Preferences::post(httpd_req_t * req) {
 	    *end = 0;
 	    char const * s = form.get();
 	    ESP_LOGI(name, "%s", s);
+	    KeyValueBroker::Batch batch;
 	    while (*s) {
 		char * t = const_cast<char *>(s);
 		char const * k = t; percentDecode(t, s, '=');
@@ -41,8 +43,9 @@ esp_err_t Preferences::post(httpd_req_t * req) {
 		char const * v = t; percentDecode(t, s, '&');
 		if (*s && '&' != *s++) break;
 		*t++ = 0;
-		keyValueBroker.publish(k, v);
+		batch.emplace_back(k, v);
 	    }
+	    keyValueBroker.publish(batch);
 	}
     }
     httpd_resp_set_type(req, "text/html; charset=utf-8");
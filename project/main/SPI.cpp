@@ -3,7 +3,10 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/portmacro.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
 
+#include "esp_attr.h"
 #include "esp_err.h"
 
 #include "SPI.h"
@@ -147,4 +150,98 @@ Transaction::~Transaction() {
     assert(result == &config);
 }
 
+// the SPI driver calls postCallback from its ISR for every transaction
+// on the device.
+// those from an AsyncTransaction have it as their user.
+// we cannot post to asio from an ISR so we defer (through the FreeRTOS
+// timer daemon task) to completeThat, which can.
+// the sequence number distinguishes this completion from that of a
+// transaction that might be queued (after a wait) before its handler runs.
+// if the timer daemon task's queue is full, the completion is lost
+// and we note that for the next queue (or wait) to make up for it.
+
+/* static */ void IRAM_ATTR AsyncTransaction::postCallback(
+	spi_transaction_t * transaction) {
+    if (auto that = static_cast<AsyncTransaction *>(transaction->user)) {
+	BaseType_t woken {pdFALSE};
+	if (pdPASS != xTimerPendFunctionCallFromISR(
+		completeThat, that, that->queued, &woken)) {
+	    that->lost = true;
+	}
+	if (woken) portYIELD_FROM_ISR();
+    }
+}
+
+/* static */ void AsyncTransaction::completeThat(
+	void * that_, uint32_t sequence) {
+    auto that = static_cast<AsyncTransaction *>(that_);
+    that->io.post([that, sequence](){
+	that->completeThis(sequence);
+    });
+}
+
+void AsyncTransaction::completeThis(uint32_t sequence) {
+    if (pending && sequence == queued) {
+	wait();
+	if (complete) complete();
+    }
+}
+
+AsyncTransaction::AsyncTransaction(
+    Device const &	device_,
+    asio::io_context &	io_)
+:
+    device	(device_),
+    io		(io_),
+    config	(),
+    complete	(),
+    queued	(0),
+    lost	(false),
+    pending	(false)
+{}
+
+void AsyncTransaction::queue(
+    Transaction::Config const &	config_,
+    std::function<void()>	complete_)
+{
+    if (pending && lost) {
+	// the last transaction is done but its completion was lost
+	wait();
+	if (complete) complete();
+    }
+    wait();
+    config = config_;
+    config.user = this;
+    complete = complete_;
+    ++queued;
+    pending = true;
+    ESP_ERROR_CHECK(
+	spi_device_queue_trans(device, &config, portMAX_DELAY));
+}
+
+bool AsyncTransaction::isPending() const {return pending;}
+
+void AsyncTransaction::wait() {
+    if (pending) {
+	spi_transaction_t * result;
+	ESP_ERROR_CHECK(
+	    spi_device_get_trans_result(device, &result, portMAX_DELAY));
+	assert(result == &config);
+	pending = false;
+	lost = false;
+    }
+}
+
+AsyncTransaction::~AsyncTransaction() {
+    wait();
+    // make sure the timer daemon task is done with us
+    // by waiting for a function pended after any completeThat.
+    SemaphoreHandle_t const done {xSemaphoreCreateBinary()};
+    xTimerPendFunctionCall([](void * done, uint32_t) {
+	xSemaphoreGive(static_cast<SemaphoreHandle_t>(done));
+    }, done, 0, portMAX_DELAY);
+    xSemaphoreTake(done, portMAX_DELAY);
+    vSemaphoreDelete(done);
+}
+
 }
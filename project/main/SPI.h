@@ -1,5 +1,9 @@
 #pragma once
 
+#include <functional>
+
+#include "asio.hpp"
+
 #include "driver/spi_common.h"
 #include "driver/spi_master.h"
 
@@ -125,4 +129,55 @@ public:
     ~Transaction();
 };
 
+/// An SPI::AsyncTransaction is a long-lived alternative to an SPI::Transaction
+/// for an SPI::Device that is configured with postCallback as its post_cb.
+/// Queuing a transaction through it does not block
+/// (unless its previous transaction is still pending).
+/// Instead, when the transaction is done, its result is reaped and
+/// the complete function is called from a handler posted to io.
+/// Should the completion not be deferred from the ISR
+/// (the timer daemon task's queue is full), it is made up for
+/// by the next queue (or wait, without calling complete).
+/// Its destructor waits for any pending transaction
+/// and must not be called while io may still run its handlers.
+class AsyncTransaction {
+private:
+    Device const &		device;
+    asio::io_context &		io;
+    Transaction::Config		config;
+    std::function<void()>	complete;
+    uint32_t volatile		queued;		///< sequence number
+    bool volatile		lost;		///< completion not deferred
+    bool			pending;
+
+    void completeThis(uint32_t sequence);
+    static void completeThat(void * that, uint32_t sequence);
+
+public:
+    /// post_cb for the SPI::Device (run from its ISR)
+    static void postCallback(spi_transaction_t * transaction);
+
+    AsyncTransaction(
+	Device const &		device,
+	asio::io_context &	io);
+
+    AsyncTransaction(AsyncTransaction const &) = delete;
+    AsyncTransaction & operator=(AsyncTransaction const &) = delete;
+
+    /// queue a transaction, configured as with an SPI::Transaction,
+    /// after waiting for any pending one.
+    void queue(
+	Transaction::Config const &	config,
+	std::function<void()>		complete = nullptr);
+
+    /// true if the last transaction queued has not been reaped
+    bool isPending() const;
+
+    /// block until the last transaction queued is done.
+    /// its complete function will not be called.
+    void wait();
+
+    ~AsyncTransaction();
+};
+
 }
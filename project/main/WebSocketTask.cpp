@@ -26,10 +26,33 @@ WebSocketTask::Frame::Frame(
     opCode	(opCode_),
     reserved	(0),
     fin		(fin_),
-    length	(length_),
+    // a longer length is extended (see writeFrame)
+    length	(126 > length_ ? length_ : 0x10000 > length_ ? 126 : 127),
     mask	(mask_)
+{}
+
+/* static */ void WebSocketTask::writeFrame(
+    std::ostream &	ostream,
+    void const *	message,
+    size_t		length,
+    OpCode		opCode,
+    bool		fin)
 {
-    assert(126 > length);
+    Frame frame(length, opCode, fin);
+    ostream.write(reinterpret_cast<char const *>(&frame), sizeof frame);
+    if (126 == frame.length) {
+	uint16_t const extended = htons(length);
+	ostream.write(reinterpret_cast<char const *>(&extended),
+	    sizeof extended);
+    } else if (127 == frame.length) {
+	uint8_t extended[8];
+	for (size_t i = 0; i < sizeof extended; ++i) {
+	    extended[i] = static_cast<uint64_t>(length) >> 8 * (7 - i);
+	}
+	ostream.write(reinterpret_cast<char const *>(extended),
+	    sizeof extended);
+    }
+    ostream.write(static_cast<char const *>(message), length);
 }
 
 void WebSocketTask::acceptSession() {
@@ -90,9 +113,7 @@ void WebSocketTask::Session::send(
 {
     auto streambuf = std::make_shared<asio::streambuf>();
     std::ostream ostream(streambuf.get());
-    Frame frame(length, opCode, fin);
-    ostream.write(reinterpret_cast<char const *>(&frame), sizeof frame);
-    ostream.write(static_cast<char const *>(message), length);
+    writeFrame(ostream, message, length, opCode, fin);
     auto hold(shared_from_this());
     asio::async_write(socket, *streambuf.get(),
 	[this, hold, streambuf](
@@ -315,6 +336,12 @@ void WebSocketTask::Session::handshake() {
 				    ec.value(), ec.message().c_str());
 			    } else {
 				takeHold();
+				// bring our client up to date
+				std::shared_ptr<KeyValueBroker::Snapshot const>
+				    snapshot(webSocketTask.generalObserver
+					.keyValueBroker.snapshot());
+				send(snapshot->json.c_str(),
+				    snapshot->json.size());
 				receive();
 			    }
 			}
@@ -350,9 +377,7 @@ void WebSocketTask::spray(
     if (!heldSessions.size()) return;
     auto streambuf = std::make_shared<asio::streambuf>();
     std::ostream ostream(streambuf.get());
-    Frame frame(length, opCode, fin);
-    ostream.write(reinterpret_cast<char const *>(&frame), sizeof frame);
-    ostream.write(static_cast<char const *>(message), length);
+    writeFrame(ostream, message, length, opCode, fin);
     for (auto & session: heldSessions) {
 	asio::async_write(session->socket, *streambuf.get(),
 	    [this, streambuf, session](
@@ -374,13 +399,18 @@ WebSocketTask::WebSocketTask(KeyValueBroker & keyValueBroker)
 :
     AsioTask("webSocketTask", 5, 4096, 0),
     acceptor(io, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), 81)),
-    generalObserver(keyValueBroker,
+    // observe (and spray) from our io
+    generalObserver(keyValueBroker, io,
 	[this](char const * key, char const * value, bool fromPeer) {
 	    std::string message = KeyValueBroker::serialize(key, value);
-	    io.post([this, message](){
-		ESP_LOGI(name, "spray %s", message.c_str());
-		spray(message.c_str(), message.size());
-	    });
+	    ESP_LOGI(name, "spray %s", message.c_str());
+	    spray(message.c_str(), message.size());
+	},
+	// spray a batch as one message
+	[this](KeyValueBroker::Batch const & batch, bool fromPeer) {
+	    std::string message = KeyValueBroker::serialize(batch);
+	    ESP_LOGI(name, "spray %s", message.c_str());
+	    spray(message.c_str(), message.size());
 	}
     )
 {
@@ -42,6 +42,14 @@ private:
 	Frame(size_t length, OpCode opCode, bool fin, bool mask = false);
     };
 
+    /// write a frame of length bytes of message to ostream
+    static void writeFrame(
+	std::ostream &	ostream,
+	void const *	message,
+	size_t		length,
+	OpCode		opCode,
+	bool		fin);
+
     void acceptSession();
 
     class Session : public std::enable_shared_from_this<Session> {
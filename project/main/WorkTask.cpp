@@ -0,0 +1,18 @@
+#include "WorkTask.h"
+
+WorkTask::WorkTask(
+    char const *	name,
+    UBaseType_t		priority,
+    size_t		stackSize,
+    BaseType_t		core)
+:
+    AsioTask	{name, priority, stackSize, core}
+{}
+
+/* virtual */ void WorkTask::run() {
+    // create some dummy work ...
+    asio::io_service::work work(io);
+
+    // ... so that we will run forever
+    AsioTask::run();
+}
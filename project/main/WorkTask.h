@@ -0,0 +1,16 @@
+#pragma once
+
+#include "AsioTask.h"
+
+/// A WorkTask is an AsioTask that runs (until stopped)
+/// whatever work is posted to its io_context.
+class WorkTask : public AsioTask {
+public:
+    WorkTask(
+	char const *	name,
+	UBaseType_t	priority,
+	size_t		stackSize,
+	BaseType_t	core = tskNO_AFFINITY);
+
+    /* virtual */ void run() override;
+};
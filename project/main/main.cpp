@@ -85,6 +85,9 @@ public:
 	Preferences preferences;
 	PeerTask peerTask;
 	WebSocketTask webSocketTask;
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+	Httpd::Uri captureUri;
+#endif
 	Connected(Main & main_)
 	:
 	    main(main_),
@@ -96,6 +99,15 @@ public:
 		preferencesFavicon1 - preferencesFavicon0),
 	    peerTask(main.keyValueBroker),
 	    webSocketTask(main.keyValueBroker)
+#ifdef CONFIG_ARTLIGHT_CAPTURE
+	    , captureUri(preferences, "/capture", HTTP_GET,
+		[this](httpd_req_t * req) {
+		    httpd_resp_set_type(req, "application/octet-stream");
+		    std::string const capture = main.artTask.capture();
+		    httpd_resp_send(req, capture.data(), capture.length());
+		    return ESP_OK;
+		})
+#endif
 	{
 	    ESP_LOGI(main.name, "Connected");
 	    otaTask.start();
@@ -185,6 +185,8 @@ ifelse(-1, regexp(ArtLightApplication, «clock\|cornhole»), , «dnl
 ifelse(«golden», ArtLightApplication, «dnl
 						<option value='swirl'>Swirl</option>
 						<option value='solid'>Solid</option>
+						<option value='playback'>Playback</option>
+						<option value='stream'>Stream</option>
 »)dnl
 ifelse(«nixie», ArtLightApplication, «dnl
 						<option value='count'>Count</option>
@@ -367,6 +369,12 @@ ifelse(«golden», ArtLightApplication, «dnl
 					<label class='tab0' for='_port'>Port</label>
 					<input type='number' id='_port' name='_port' required='true' min='0' max='49151' placeholder=''/>
 				</div>
+ifelse(«golden», ArtLightApplication, «dnl
+				<div>
+					<label class='tab0' for='_streamPort' title='DDP pixel stream UDP port'>Stream Port</label>
+					<input type='number' id='_streamPort' name='_streamPort' required='true' min='0' max='49151' placeholder=''/>
+				</div>
+»)dnl
 			</fieldset>
 			<fieldset>
 				<legend>Time Acquisition</legend>
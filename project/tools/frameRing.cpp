@@ -0,0 +1,145 @@
+// frameRing stress tests a FrameRing (see ../main/FrameRing.h)
+// with a producer thread and a consumer thread
+// that is woken only when the ring says that it must be,
+// as GoldenArtTask does with its transmitTask.
+//
+// build (on the host) with ThreadSanitizer:
+//
+//	g++ -std=c++11 -O2 -g -fsanitize=thread -I../main -o frameRing frameRing.cpp -pthread
+//
+// run (for count frames, 1000000 by default):
+//
+//	./frameRing [count]
+//
+// it fails (with an exit status of 1) if a frame is seen out of order,
+// torn or not at all or if it is left in the ring.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#include "FrameRing.h"
+
+namespace {
+
+// a frame with a sequence number in every word so that a torn one shows
+struct Slot {
+    unsigned	sequence[16];
+};
+
+// a posted handler queue, like that of an asio::io_context, of wakes.
+class Wakes {
+private:
+    std::mutex			mutex;
+    std::condition_variable	condition;
+    unsigned			pending {0};
+    bool			stopped {false};
+public:
+    unsigned			posted {0};
+
+    void post() {
+	std::lock_guard<std::mutex> lock {mutex};
+	++pending;
+	++posted;
+	condition.notify_one();
+    }
+
+    void stop() {
+	std::lock_guard<std::mutex> lock {mutex};
+	stopped = true;
+	condition.notify_one();
+    }
+
+    /// false when stopped and there are no more wakes
+    bool wait() {
+	std::unique_lock<std::mutex> lock {mutex};
+	condition.wait(lock, [this](){return pending || stopped;});
+	if (!pending) return false;
+	--pending;
+	return true;
+    }
+};
+
+}
+
+int main(int argc, char ** argv) {
+    unsigned const count {argc > 1
+	? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+	: 1000000u};
+
+    FrameRing<Slot, 2> ring;
+    Wakes wakes;
+    unsigned pushed {0};
+    unsigned popped {0};
+    unsigned errors {0};
+    unsigned consumerErrors {0};
+
+    std::thread consumer {[&](){
+	unsigned expected {0};
+	while (wakes.wait()) {
+	    do {
+		while (Slot const * const slot = ring.front()) {
+		    unsigned const sequence {slot->sequence[0]};
+		    for (auto s: slot->sequence) {
+			if (s != sequence) {
+			    std::fprintf(stderr, "torn %u\n", sequence);
+			    ++consumerErrors;
+			    break;
+			}
+		    }
+		    if (sequence < expected) {
+			std::fprintf(stderr, "%u after %u\n", sequence, expected);
+			++consumerErrors;
+		    }
+		    expected = sequence + 1;
+		    ++popped;
+		    ring.pop();
+		}
+	    } while (!ring.idle());
+	}
+    }};
+
+    // wait (not too long) for the consumer to drain the ring.
+    // a frame that it was not woken for would be left there.
+    auto const drained = [&ring](){
+	auto const timeout
+	    {std::chrono::steady_clock::now() + std::chrono::seconds(1)};
+	while (ring.occupancy()) {
+	    if (std::chrono::steady_clock::now() > timeout) return false;
+	    std::this_thread::yield();
+	}
+	return true;
+    };
+
+    for (unsigned sequence {0}; sequence < count; ++sequence) {
+	if (Slot * const slot = ring.back()) {
+	    for (auto & s: slot->sequence) s = sequence;
+	    ++pushed;
+	    if (ring.push()) wakes.post();
+	}
+	// every so often, let the consumer catch up and go idle
+	if (!(sequence % 64) && !drained()) {
+	    std::fprintf(stderr, "left %u at %u\n", ring.occupancy(), sequence);
+	    ++errors;
+	    break;
+	}
+    }
+    if (!drained()) {
+	std::fprintf(stderr, "left %u\n", ring.occupancy());
+	++errors;
+    }
+    wakes.stop();
+    consumer.join();
+    errors += consumerErrors;
+
+    if (pushed != popped) {
+	std::fprintf(stderr, "pushed %u popped %u\n", pushed, popped);
+	++errors;
+    }
+    std::printf("frames %u pushed %u dropped %u wakes %u errors %u\n",
+	count, pushed, ring.drops(), wakes.posted, errors);
+    return errors ? 1 : 0;
+}
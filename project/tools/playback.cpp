@@ -0,0 +1,116 @@
+// playback converts frames rendered offline to and from the Capture format
+// (see ../main/Capture.h) used for golden playback mode.
+//
+// build (on the host):
+//
+//	g++ -std=c++11 -O2 -I../main -o playback playback.cpp ../main/Capture.cpp
+//
+// encode raw frames (ledCount * 3 bytes of red, green and blue each,
+// in rendering order) rendered at framesPerSecond:
+//
+//	./playback encode 1024 25 < frames.rgb > frames.alfc
+//
+// decode (memory mapped) frames to raw frames
+// (frame times and sizes are written to stderr):
+//
+//	./playback decode frames.alfc > frames.rgb
+//
+// flash frames to the frames partition of a connected device:
+//
+//	parttool.py --port $port write_partition --partition-name frames --input frames.alfc
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Capture.h"
+
+static int usage(char const * name) {
+    std::fprintf(stderr,
+	"usage:\t%s encode ledCount framesPerSecond < rgb > stream\n"
+	"\t%s decode stream > rgb\n", name, name);
+    return 2;
+}
+
+// an APA102::LED<uint8_t> encoding with a full (0b11111) scaling factor.
+// its bytes are control, blue, green and red.
+static uint32_t encode(uint8_t red, uint8_t green, uint8_t blue) {
+    return 0xff | blue << 8 | green << 16 | static_cast<uint32_t>(red) << 24;
+}
+
+static int encode(std::size_t ledCount, double framesPerSecond) {
+    Capture::FileSink sink {stdout};
+    Capture::Recorder recorder {sink, Capture::Chip::apa102, ledCount};
+    std::vector<uint8_t> rgb(ledCount * 3);
+    std::vector<uint32_t> encodings(ledCount);
+    for (uint64_t frame = 0;
+	    rgb.size() == std::fread(rgb.data(), 1, rgb.size(), stdin);
+	    ++frame) {
+	for (std::size_t i = 0; i < ledCount; ++i) {
+	    encodings[i] = encode(rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+	}
+	recorder.record(frame * 1000000 / framesPerSecond, encodings.data());
+    }
+    return std::fflush(stdout) ? 1 : 0;
+}
+
+static int decode(char const * path) {
+    int const fd {open(path, O_RDONLY)};
+    struct stat status;
+    if (0 > fd || fstat(fd, &status)) {
+	std::perror(path);
+	return 1;
+    }
+    void const * const data {mmap(nullptr, status.st_size, PROT_READ,
+	MAP_PRIVATE, fd, 0)};
+    close(fd);
+    if (MAP_FAILED == data) {
+	std::perror(path);
+	return 1;
+    }
+    Capture::Reader reader {static_cast<uint8_t const *>(data),
+	static_cast<std::size_t>(status.st_size)};
+    if (!reader) {
+	std::fprintf(stderr, "%s: not a stream\n", path);
+	return 1;
+    }
+    std::size_t const ledCount {reader.ledCount()};
+    std::fprintf(stderr, "chip %u ledCount %zu\n",
+	static_cast<unsigned>(reader.chip()), ledCount);
+    std::vector<uint8_t> rgb(ledCount * 3);
+    while (reader.next()) {
+	std::vector<uint32_t> const & encodings {reader.encodings()};
+	for (std::size_t i = 0; i < ledCount; ++i) {
+	    uint32_t const encoding {encodings[reader.layout()[i]]};
+	    rgb[i * 3 + 0] = encoding >> 24;
+	    rgb[i * 3 + 1] = encoding >> 16;
+	    rgb[i * 3 + 2] = encoding >> 8;
+	}
+	std::fwrite(rgb.data(), 1, rgb.size(), stdout);
+	std::fprintf(stderr, "%llu\n",
+	    static_cast<unsigned long long>(reader.microseconds()));
+    }
+    munmap(const_cast<void *>(data), status.st_size);
+    return std::fflush(stdout) ? 1 : 0;
+}
+
+int main(int argc, char ** argv) {
+    if (4 == argc && !std::strcmp("encode", argv[1])) {
+	std::size_t const ledCount {std::strtoul(argv[2], nullptr, 0)};
+	double const framesPerSecond {std::strtod(argv[3], nullptr)};
+	if (!ledCount || 0xffff < ledCount || !(0 < framesPerSecond)) {
+	    return usage(argv[0]);
+	}
+	return encode(ledCount, framesPerSecond);
+    }
+    if (3 == argc && !std::strcmp("decode", argv[1])) {
+	return decode(argv[2]);
+    }
+    return usage(argv[0]);
+}